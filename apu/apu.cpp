@@ -235,6 +235,27 @@ namespace spc
 	static uint32		ratio_denominator = APU_DENOMINATOR_NTSC;
 }
 
+// The part of the driver state above that belongs to one console, so that it
+// can be saved and restored with the rest of the console (see consolestate.cpp).
+struct SAPUContext
+{
+	SNES_SPC		*core;
+	apu_callback	sa_callback;
+	void			*extra_data;
+	bool8			sound_in_sync;
+	bool8			sound_enabled;
+	int				buffer_size;
+	int				lag_master;
+	int				lag;
+	uint8			*landing_buffer;
+	Resampler		*resampler;
+	int32			reference_time;
+	uint32			remainder;
+	int				timing_hack_denominator;
+	uint32			ratio_numerator;
+	uint32			ratio_denominator;
+};
+
 static void EightBitize (uint8 *, int);
 static void DeStereo (uint8 *, int);
 static void ReverseStereo (uint8 *, int);
@@ -398,6 +419,8 @@ bool8 S9xSyncSound (void)
 	if (!Settings.SoundSync || spc::sound_in_sync)
 		return (TRUE);
 
+	/* The SPC core can only hand over its samples right after end_frame. */
+	S9xAPUExecute();
 	S9xLandSamples();
 
 	return (spc::sound_in_sync);
@@ -539,6 +562,62 @@ void S9xDeinitAPU (void)
 	}
 }
 
+SAPUContext * S9xAPUNewContext (void)
+{
+	SAPUContext	*ctx = new SAPUContext;
+
+	memset(ctx, 0, sizeof(SAPUContext));
+	ctx->sound_in_sync           = TRUE;
+	ctx->timing_hack_denominator = SNES_SPC::tempo_unit;
+	ctx->ratio_numerator         = APU_NUMERATOR_NTSC;
+	ctx->ratio_denominator       = APU_DENOMINATOR_NTSC;
+
+	return (ctx);
+}
+
+void S9xAPUDeleteContext (SAPUContext *ctx)
+{
+	delete ctx;
+}
+
+void S9xAPUSaveContext (SAPUContext *ctx)
+{
+	ctx->core                    = spc_core;
+	ctx->sa_callback             = spc::sa_callback;
+	ctx->extra_data              = spc::extra_data;
+	ctx->sound_in_sync           = spc::sound_in_sync;
+	ctx->sound_enabled           = spc::sound_enabled;
+	ctx->buffer_size             = spc::buffer_size;
+	ctx->lag_master              = spc::lag_master;
+	ctx->lag                     = spc::lag;
+	ctx->landing_buffer          = spc::landing_buffer;
+	ctx->resampler               = spc::resampler;
+	ctx->reference_time          = spc::reference_time;
+	ctx->remainder               = spc::remainder;
+	ctx->timing_hack_denominator = spc::timing_hack_denominator;
+	ctx->ratio_numerator         = spc::ratio_numerator;
+	ctx->ratio_denominator       = spc::ratio_denominator;
+}
+
+void S9xAPULoadContext (SAPUContext *ctx)
+{
+	spc_core                     = ctx->core;
+	spc::sa_callback             = ctx->sa_callback;
+	spc::extra_data              = ctx->extra_data;
+	spc::sound_in_sync           = ctx->sound_in_sync;
+	spc::sound_enabled           = ctx->sound_enabled;
+	spc::buffer_size             = ctx->buffer_size;
+	spc::lag_master              = ctx->lag_master;
+	spc::lag                     = ctx->lag;
+	spc::landing_buffer          = ctx->landing_buffer;
+	spc::resampler               = ctx->resampler;
+	spc::reference_time          = ctx->reference_time;
+	spc::remainder               = ctx->remainder;
+	spc::timing_hack_denominator = ctx->timing_hack_denominator;
+	spc::ratio_numerator         = ctx->ratio_numerator;
+	spc::ratio_denominator       = ctx->ratio_denominator;
+}
+
 static inline int S9xAPUGetClock (int32 cpucycles)
 {
 	return (spc::ratio_numerator * (cpucycles - spc::reference_time) + spc::remainder) /
@@ -566,6 +645,11 @@ void S9xAPUSetReferenceTime (int32 cpucycles)
 	spc::reference_time = cpucycles;
 }
 
+void S9xAPUShiftReferenceTime (int32 cpucycles)
+{
+	spc::reference_time += cpucycles;
+}
+
 void S9xAPUExecute (void)
 {
 	/* Accumulate partial APU cycles */
@@ -578,6 +662,12 @@ void S9xAPUExecute (void)
 
 void S9xAPUEndScanline (void)
 {
+	/* Port accesses catch the SPC700 up by themselves, so only run it here
+	   once it owes a block of samples (32 clocks per stereo sample). */
+	if (spc::sound_in_sync &&
+		spc_core->sample_count() + (S9xAPUGetClock(CPU.Cycles) >> 4) < APU_MINIMUM_SAMPLE_BLOCK)
+		return;
+
 	S9xAPUExecute();
 
 	if (spc_core->sample_count() >= APU_MINIMUM_SAMPLE_BLOCK || !spc::sound_in_sync)
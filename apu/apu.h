@@ -184,6 +184,8 @@
 
 typedef void (*apu_callback) (void *);
 
+struct SAPUContext;
+
 #define SPC_SAVE_STATE_BLOCK_SIZE	(SNES_SPC::state_size + 8)
 
 bool8 S9xInitAPU (void);
@@ -195,6 +197,7 @@ void S9xAPUWritePort (int, uint8);
 void S9xAPUExecute (void);
 void S9xAPUEndScanline (void);
 void S9xAPUSetReferenceTime (int32);
+void S9xAPUShiftReferenceTime (int32);
 void S9xAPUTimingSetSpeedup (int);
 void S9xAPUAllowTimeOverflow (bool);
 void S9xAPULoadState (uint8 *);
@@ -214,6 +217,11 @@ void S9xClearSamples (void);
 bool8 S9xMixSamples (uint8 *, int);
 void S9xSetSamplesAvailableCallback (apu_callback, void *);
 
+SAPUContext * S9xAPUNewContext (void);
+void S9xAPUDeleteContext (SAPUContext *);
+void S9xAPUSaveContext (SAPUContext *);
+void S9xAPULoadContext (SAPUContext *);
+
 extern SNES_SPC	*spc_core;
 
 #endif
@@ -5,47 +5,57 @@
 
 #include "resampler.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HERMITE_SSE2
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HERMITE_NEON
+#endif
+
 #undef CLAMP
 #undef SHORT_CLAMP
 #define CLAMP(x, low, high) (((x) > (high)) ? (high) : (((x) < (low)) ? (low) : (x)))
 #define SHORT_CLAMP(n) ((short) CLAMP((n), -32768, 32767))
 
+/* Both channels share the same position, so the Hermite basis is computed
+   once per output frame and applied to left and right together. With
+   tension and bias at zero the tangents reduce to (c - a) / 2 and
+   (d - b) / 2, which only change when a new input frame is shifted in. */
+
 class HermiteResampler : public Resampler
 {
     protected:
 
         double r_step;
         double r_frac;
-        int    r_left[4], r_right[4];
+        double r_history[4][2];
 
-        double
-        hermite (double mu1, double a, double b, double c, double d)
+        void
+        reset (void)
         {
-            const double tension = 0.0; //-1 = low, 0 = normal, 1 = high
-            const double bias    = 0.0; //-1 = left, 0 = even, 1 = right
-
-            double mu2, mu3, m0, m1, a0, a1, a2, a3;
-
-            mu2 = mu1 * mu1;
-            mu3 = mu2 * mu1;
+            r_frac = 1.0;
+            memset (r_history, 0, sizeof (r_history));
+        }
 
-            m0  = (b - a) * (1 + bias) * (1 - tension) / 2;
-            m0 += (c - b) * (1 - bias) * (1 - tension) / 2;
-            m1  = (c - b) * (1 + bias) * (1 - tension) / 2;
-            m1 += (d - c) * (1 - bias) * (1 - tension) / 2;
+        /* Passes input straight through when no rate conversion is needed */
+        int
+        copy (short *data, int num_samples, int filled)
+        {
+            int count = MIN (num_samples, filled);
+            int first = MIN (count, (int) (mask + 1 - (tail & mask)) >> 1);
 
-            a0 = +2 * mu3 - 3 * mu2 + 1;
-            a1 =      mu3 - 2 * mu2 + mu1;
-            a2 =      mu3 -     mu2;
-            a3 = -2 * mu3 + 3 * mu2;
+            memcpy (data, at (tail), first << 1);
+            if (count > first)
+                memcpy (data + first, buffer, (count - first) << 1);
 
-            return (a0 * b) + (a1 * m0) + (a2 * m1) + (a3 * c);
+            return count;
         }
 
     public:
         HermiteResampler (int num_samples) : Resampler (num_samples)
         {
-            clear ();
+            reset ();
         }
 
         ~HermiteResampler ()
@@ -63,44 +73,88 @@ class HermiteResampler : public Resampler
         clear (void)
         {
             ring_buffer::clear ();
-            r_frac = 1.0;
-            r_left [0] = r_left [1] = r_left [2] = r_left [3] = 0;
-            r_right[0] = r_right[1] = r_right[2] = r_right[3] = 0;
         }
 
         void
         read (short *data, int num_samples)
         {
-            int i_position = start >> 1;
-            short *internal_buffer = (short *) buffer;
+            if (catch_up ())
+                reset ();
+
+            int filled = space_filled () >> 1;
             int o_position = 0;
             int consumed = 0;
+            const double margin_of_error = 1.0e-10;
 
-            while (o_position < num_samples && consumed < buffer_size)
+            if (fabs (r_step - 1.0) < margin_of_error)
             {
-                int s_left = internal_buffer[i_position];
-                int s_right = internal_buffer[i_position + 1];
-                int max_samples = buffer_size >> 1;
-                const double margin_of_error = 1.0e-10;
-
-                if (fabs(r_step - 1.0) < margin_of_error)
-                {
-                    data[o_position] = (short) s_left;
-                    data[o_position + 1] = (short) s_right;
-
-                    o_position += 2;
-                    i_position += 2;
-                    if (i_position >= max_samples)
-                        i_position -= max_samples;
-                    consumed += 2;
+                consume (copy (data, num_samples, filled) << 1);
+                return;
+            }
 
-                    continue;
-                }
+#if defined(HERMITE_SSE2)
+            __m128d a = _mm_loadu_pd (r_history[0]);
+            __m128d b = _mm_loadu_pd (r_history[1]);
+            __m128d c = _mm_loadu_pd (r_history[2]);
+            __m128d d = _mm_loadu_pd (r_history[3]);
+            const __m128d half = _mm_set1_pd (0.5);
+            __m128d m0 = _mm_mul_pd (_mm_sub_pd (c, a), half);
+            __m128d m1 = _mm_mul_pd (_mm_sub_pd (d, b), half);
+#elif defined(HERMITE_NEON)
+            float64x2_t a = vld1q_f64 (r_history[0]);
+            float64x2_t b = vld1q_f64 (r_history[1]);
+            float64x2_t c = vld1q_f64 (r_history[2]);
+            float64x2_t d = vld1q_f64 (r_history[3]);
+            float64x2_t m0 = vmulq_n_f64 (vsubq_f64 (c, a), 0.5);
+            float64x2_t m1 = vmulq_n_f64 (vsubq_f64 (d, b), 0.5);
+#else
+            double (*h)[2] = r_history;
+            double m0[2], m1[2];
+
+            for (int ch = 0; ch < 2; ch++)
+            {
+                m0[ch] = (h[2][ch] - h[0][ch]) * 0.5;
+                m1[ch] = (h[3][ch] - h[1][ch]) * 0.5;
+            }
+#endif
 
+            while (o_position < num_samples && consumed < filled)
+            {
                 while (r_frac <= 1.0 && o_position < num_samples)
                 {
-                    data[o_position]     = SHORT_CLAMP (hermite (r_frac, r_left [0], r_left [1], r_left [2], r_left [3]));
-                    data[o_position + 1] = SHORT_CLAMP (hermite (r_frac, r_right[0], r_right[1], r_right[2], r_right[3]));
+                    double mu1 = r_frac;
+                    double mu2 = mu1 * mu1;
+                    double mu3 = mu2 * mu1;
+
+                    double a0 = +2 * mu3 - 3 * mu2 + 1;
+                    double a1 =      mu3 - 2 * mu2 + mu1;
+                    double a2 =      mu3 -     mu2;
+                    double a3 = -2 * mu3 + 3 * mu2;
+
+                    /* The conversion saturates, which matches SHORT_CLAMP */
+#if defined(HERMITE_SSE2)
+                    __m128d v = _mm_add_pd (_mm_add_pd (_mm_add_pd (_mm_mul_pd (_mm_set1_pd (a0), b),
+                                                                    _mm_mul_pd (_mm_set1_pd (a1), m0)),
+                                                        _mm_mul_pd (_mm_set1_pd (a2), m1)),
+                                            _mm_mul_pd (_mm_set1_pd (a3), c));
+                    __m128i s = _mm_cvttpd_epi32 (v);
+                    s = _mm_packs_epi32 (s, s);
+
+                    int frame = _mm_cvtsi128_si32 (s);
+                    memcpy (data + o_position, &frame, sizeof (frame));
+#elif defined(HERMITE_NEON)
+                    float64x2_t v = vaddq_f64 (vaddq_f64 (vaddq_f64 (vmulq_n_f64 (b, a0),
+                                                                     vmulq_n_f64 (m0, a1)),
+                                                          vmulq_n_f64 (m1, a2)),
+                                               vmulq_n_f64 (c, a3));
+                    int32x2_t s = vqmovn_s64 (vcvtq_s64_f64 (v));
+
+                    data[o_position]     = SHORT_CLAMP (vget_lane_s32 (s, 0));
+                    data[o_position + 1] = SHORT_CLAMP (vget_lane_s32 (s, 1));
+#else
+                    for (int ch = 0; ch < 2; ch++)
+                        data[o_position + ch] = SHORT_CLAMP ((a0 * h[1][ch]) + (a1 * m0[ch]) + (a2 * m1[ch]) + (a3 * h[2][ch]));
+#endif
 
                     o_position += 2;
 
@@ -109,35 +163,65 @@ class HermiteResampler : public Resampler
 
                 if (r_frac > 1.0)
                 {
-                    r_left [0] = r_left [1];
-                    r_left [1] = r_left [2];
-                    r_left [2] = r_left [3];
-                    r_left [3] = s_left;
-    
-                    r_right[0] = r_right[1];
-                    r_right[1] = r_right[2];
-                    r_right[2] = r_right[3];
-                    r_right[3] = s_right;                    
-                    
+                    short *frame = (short *) at (tail + (consumed << 1));
+
+#if defined(HERMITE_SSE2)
+                    a = b;
+                    b = c;
+                    c = d;
+                    d = _mm_set_pd ((double) frame[1], (double) frame[0]);
+                    m0 = _mm_mul_pd (_mm_sub_pd (c, a), half);
+                    m1 = _mm_mul_pd (_mm_sub_pd (d, b), half);
+#elif defined(HERMITE_NEON)
+                    double in[2] = { (double) frame[0], (double) frame[1] };
+
+                    a = b;
+                    b = c;
+                    c = d;
+                    d = vld1q_f64 (in);
+                    m0 = vmulq_n_f64 (vsubq_f64 (c, a), 0.5);
+                    m1 = vmulq_n_f64 (vsubq_f64 (d, b), 0.5);
+#else
+                    for (int ch = 0; ch < 2; ch++)
+                    {
+                        h[0][ch] = h[1][ch];
+                        h[1][ch] = h[2][ch];
+                        h[2][ch] = h[3][ch];
+                        h[3][ch] = frame[ch];
+
+                        m0[ch] = (h[2][ch] - h[0][ch]) * 0.5;
+                        m1[ch] = (h[3][ch] - h[1][ch]) * 0.5;
+                    }
+#endif
+
                     r_frac -= 1.0;
-                    
-                    i_position += 2;
-                    if (i_position >= max_samples)
-                        i_position -= max_samples;
+
                     consumed += 2;
                 }
             }
 
-            size -= consumed << 1;
-            start += consumed << 1;
-            if (start >= buffer_size)
-                start -= buffer_size;
+#if defined(HERMITE_SSE2)
+            _mm_storeu_pd (r_history[0], a);
+            _mm_storeu_pd (r_history[1], b);
+            _mm_storeu_pd (r_history[2], c);
+            _mm_storeu_pd (r_history[3], d);
+#elif defined(HERMITE_NEON)
+            vst1q_f64 (r_history[0], a);
+            vst1q_f64 (r_history[1], b);
+            vst1q_f64 (r_history[2], c);
+            vst1q_f64 (r_history[3], d);
+#endif
+
+            consume (consumed << 1);
         }
 
         inline int
         avail (void)
         {
-            return (int) floor (((size >> 2) - r_frac) / r_step) * 2;
+            if (catch_up ())
+                reset ();
+
+            return (int) floor (((space_filled () >> 2) - r_frac) / r_step) * 2;
         }
 };
 
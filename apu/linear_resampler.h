@@ -19,10 +19,18 @@ class LinearResampler : public Resampler
         uint32 f__r_frac;
         int    r_left, r_right;
 
+        void
+        reset (void)
+        {
+            f__r_frac = 0;
+            r_left = 0;
+            r_right = 0;
+        }
+
     public:
         LinearResampler (int num_samples) : Resampler (num_samples)
         {
-            f__r_frac = 0;
+            reset ();
         }
 
         ~LinearResampler ()
@@ -43,31 +51,28 @@ class LinearResampler : public Resampler
         clear (void)
         {
             ring_buffer::clear ();
-            f__r_frac = 0;
-            r_left = 0;
-            r_right = 0;
         }
 
         void
         read (short *data, int num_samples)
         {
-            int i_position = start >> 1;
-            short *internal_buffer = (short *) buffer;
+            if (catch_up ())
+                reset ();
+
+            int filled = space_filled () >> 1;
             int o_position = 0;
             int consumed = 0;
-            int max_samples = (buffer_size >> 1);
 
-            while (o_position < num_samples && consumed < buffer_size)
+            while (o_position < num_samples && consumed < filled)
             {
+                short *internal_buffer = (short *) at (tail + (consumed << 1));
+
                 if (f__r_step == f__one)
                 {
-                    data[o_position] = internal_buffer[i_position];
-                    data[o_position + 1] = internal_buffer[i_position + 1];
+                    data[o_position] = internal_buffer[0];
+                    data[o_position + 1] = internal_buffer[1];
 
                     o_position += 2;
-                    i_position += 2;
-                    if (i_position >= max_samples)
-                        i_position -= max_samples;
                     consumed += 2;
 
                     continue;
@@ -77,10 +82,10 @@ class LinearResampler : public Resampler
                 {
                     data[o_position]     = lerp (f__r_frac,
                                                  r_left,
-                                                 internal_buffer[i_position]);
+                                                 internal_buffer[0]);
                     data[o_position + 1] = lerp (f__r_frac,
                                                  r_right,
-                                                 internal_buffer[i_position + 1]);
+                                                 internal_buffer[1]);
 
                     o_position += 2;
 
@@ -90,25 +95,22 @@ class LinearResampler : public Resampler
                 if (f__r_frac > f__one)
                 {
                     f__r_frac -= f__one;
-                    r_left = internal_buffer[i_position];
-                    r_right = internal_buffer[i_position + 1];
-                    i_position += 2;
-                    if (i_position >= max_samples)
-                        i_position -= max_samples;
+                    r_left = internal_buffer[0];
+                    r_right = internal_buffer[1];
                     consumed += 2;
                 }
             }
 
-            size -= consumed << 1;
-            start += consumed << 1;
-            if (start >= buffer_size)
-                start -= buffer_size;
+            consume (consumed << 1);
         }
 
         inline int
         avail (void)
         {
-            return (((size >> 2) * f__inv_r_step) - ((f__r_frac * f__inv_r_step) >> f_prec)) >> (f_prec - 1);
+            if (catch_up ())
+                reset ();
+
+            return (((space_filled () >> 2) * f__inv_r_step) - ((f__r_frac * f__inv_r_step) >> f_prec)) >> (f_prec - 1);
         }
 };
 
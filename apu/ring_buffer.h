@@ -1,4 +1,4 @@
-/* Simple byte-based ring buffer. Licensed under public domain (C) BearOso. */
+/* Single-producer/single-consumer byte ring buffer. Licensed under public domain (C) BearOso. */
 
 #ifndef __RING_BUFFER_H
 #define __RING_BUFFER_H
@@ -8,23 +8,107 @@
 #undef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 
+/* One thread may push while another pulls, without any locking.
+
+   head and tail are free-running byte counters; the producer only ever
+   writes head and the consumer only ever writes tail, each after the data
+   it covers has been copied, and the two live on separate cache lines.
+   Storage is rounded up to a power of two so the counters can wrap, but
+   the usable capacity is still buffer_size bytes.
+
+   clear () may be called from either side. It only records the current
+   head as a discard point, which the consumer skips to on its next pull.
+   resize () and cache_silence () are not safe while the other side runs. */
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define RING_BUFFER_FENCE() _ReadWriteBarrier ()
+#else
+#define RING_BUFFER_FENCE() __sync_synchronize ()
+#endif
+
+#define RING_BUFFER_CACHE_LINE 64
+
 class ring_buffer
 {
 protected:
-    int size;
     int buffer_size;
-    int start;
+    unsigned int mask;
     unsigned char *buffer;
 
-public:
-    ring_buffer (int buffer_size)
+    char pad0[RING_BUFFER_CACHE_LINE];
+
+    /* Producer side */
+    volatile unsigned int head;
+    volatile unsigned int discard;
+
+    char pad1[RING_BUFFER_CACHE_LINE];
+
+    /* Consumer side */
+    volatile unsigned int tail;
+    volatile unsigned int discard_seen;
+
+    char pad2[RING_BUFFER_CACHE_LINE];
+
+    void
+    allocate (int buffer_size)
     {
         this->buffer_size = buffer_size;
-        buffer = new unsigned char[this->buffer_size];
-        memset (buffer, 0, this->buffer_size);
 
-        size = 0;
-        start = 0;
+        mask = 1;
+        while ((int) mask < buffer_size)
+            mask <<= 1;
+
+        buffer = new unsigned char[mask];
+        memset (buffer, 0, mask);
+        mask--;
+
+        head = tail = discard = discard_seen = 0;
+    }
+
+    /* Consumer only. Returns true if a clear () was applied, so resamplers
+       know to drop their interpolation history too. */
+    bool
+    catch_up (void)
+    {
+        unsigned int d = discard;
+
+        if (d == discard_seen)
+            return false;
+
+        RING_BUFFER_FENCE ();
+
+        unsigned int t = tail;
+
+        if (d - t <= head - t)
+        {
+            tail = d;
+            RING_BUFFER_FENCE ();
+        }
+
+        discard_seen = d;
+
+        return true;
+    }
+
+    /* Consumer only. Marks bytes as read once they have been copied out. */
+    inline void
+    consume (int bytes)
+    {
+        RING_BUFFER_FENCE ();
+        tail = tail + bytes;
+    }
+
+    inline unsigned char *
+    at (unsigned int index)
+    {
+        return buffer + (index & mask);
+    }
+
+public:
+    ring_buffer (int buffer_size)
+    {
+        allocate (buffer_size);
     }
 
     ~ring_buffer (void)
@@ -38,15 +122,16 @@ public:
         if (space_empty () < bytes)
             return false;
 
-        int end = (start + size) % buffer_size;
-        int first_write_size = MIN (bytes, buffer_size - end);
+        unsigned int end = head & mask;
+        int first_write_size = MIN (bytes, (int) (mask + 1 - end));
 
         memcpy (buffer + end, src, first_write_size);
 
         if (bytes > first_write_size)
             memcpy (buffer, src + first_write_size, bytes - first_write_size);
 
-        size += bytes;
+        RING_BUFFER_FENCE ();
+        head = head + bytes;
 
         return true;
     }
@@ -54,16 +139,20 @@ public:
     bool
     pull (unsigned char *dst, int bytes)
     {
+        catch_up ();
+
         if (space_filled () < bytes)
             return false;
 
-        memcpy (dst, buffer + start, MIN (bytes, buffer_size - start));
+        unsigned int start = tail & mask;
+        int first_read_size = MIN (bytes, (int) (mask + 1 - start));
 
-        if (bytes > (buffer_size - start))
-            memcpy (dst + (buffer_size - start), buffer, bytes - (buffer_size - start));
+        memcpy (dst, buffer + start, first_read_size);
 
-        start = (start + bytes) % buffer_size;
-        size -= bytes;
+        if (bytes > first_read_size)
+            memcpy (dst + first_read_size, buffer, bytes - first_read_size);
+
+        consume (bytes);
 
         return true;
     }
@@ -71,40 +160,45 @@ public:
     inline int
     space_empty (void)
     {
-        return buffer_size - size;
+        return buffer_size - space_filled ();
     }
 
+    /* Safe from either side. A pending discard point counts as read. */
     inline int
     space_filled (void)
     {
-        return size;
+        unsigned int d = discard;
+        unsigned int h = head;
+        unsigned int t = tail;
+
+        RING_BUFFER_FENCE ();
+
+        if (d != discard_seen && d - t <= h - t)
+            t = d;
+
+        return (int) (h - t);
     }
 
     void
     clear (void)
     {
-        start = 0;
-        size = 0;
-        memset (buffer, 0, buffer_size);
+        RING_BUFFER_FENCE ();
+        discard = head;
     }
 
     void
     resize (int size)
     {
         delete[] buffer;
-        buffer_size = size;
-        buffer = new unsigned char[buffer_size];
-        memset (buffer, 0, this->buffer_size);
-
-        size = 0;
-        start = 0;
+        allocate (size);
     }
 
     inline void
     cache_silence (void)
     {
-        clear ();
-        size = buffer_size;
+        memset (buffer, 0, mask + 1);
+        discard = discard_seen = tail = head;
+        head = head + buffer_size;
     }
 };
 
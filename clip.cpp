@@ -188,8 +188,23 @@ static uint8	region_map[6][6] =
 	{ 0,    0,    0,    0,    0, 0x10 }
 };
 
+// The clip windows depend on nothing but the window registers, so the results are cached by them.
+// Games that HDMA the windows repeat the same shapes line after line and frame after frame,
+// which then cost a lookup and a copy. Each render thread keeps its own cache.
+
+#define CLIP_CACHE_SIZE	256
+
+struct ClipCacheEntry
+{
+	uint32			Key[3];
+	struct ClipData	Clip[2][6];
+};
+
+static GFX_THREAD_LOCAL struct ClipCacheEntry	ClipCache[CLIP_CACHE_SIZE];
+
 static inline uint8 CalcWindowMask (int, uint8, uint8);
 static inline void StoreWindowRegions (uint8, struct ClipData *, int, int16 *, uint8 *, bool8, bool8 s = FALSE);
+static void ComputeClipWindows (void);
 
 
 static inline uint8 CalcWindowMask (int i, uint8 W1, uint8 W2)
@@ -271,7 +286,7 @@ static inline void StoreWindowRegions (uint8 Mask, struct ClipData *Clip, int n_
 	Clip->Count = ct;
 }
 
-void S9xComputeClipWindows (void)
+static void ComputeClipWindows (void)
 {
 	int16	windows[6] = { 0, 256, 256, 256, 256, 256 };
 	uint8	drawing_modes[5] = { 0, 0, 0, 0, 0 };
@@ -361,7 +376,7 @@ void S9xComputeClipWindows (void)
 	uint8	CW_color = 0, CW_math = 0;
 	uint8	CW = CalcWindowMask(5, W1, W2);
 
-	switch (Memory.FillRAM[0x2130] & 0xc0)
+	switch (GFX.FillRAM[0x2130] & 0xc0)
 	{
 		case 0x00:	CW_color = 0;		break;
 		case 0x40:	CW_color = ~CW;		break;
@@ -369,7 +384,7 @@ void S9xComputeClipWindows (void)
 		case 0xc0:	CW_color = 0xff;	break;
 	}
 
-	switch (Memory.FillRAM[0x2130] & 0x30)
+	switch (GFX.FillRAM[0x2130] & 0x30)
 	{
 		case 0x00:	CW_math  = 0;		break;
 		case 0x10:	CW_math  = ~CW;		break;
@@ -397,10 +412,37 @@ void S9xComputeClipWindows (void)
 		uint8	W = Settings.DisableGraphicWindows ? 0 : CalcWindowMask(j, W1, W2);
 		for (int sub = 0; sub < 2; sub++)
 		{
-			if (Memory.FillRAM[sub + 0x212e] & (1 << j))
+			if (GFX.FillRAM[sub + 0x212e] & (1 << j))
 				StoreWindowRegions(W, &IPPU.Clip[sub][j], n_regions, windows, drawing_modes, sub);
 			else
 				StoreWindowRegions(0, &IPPU.Clip[sub][j], n_regions, windows, drawing_modes, sub);
 		}
 	}
 }
+
+void S9xComputeClipWindows (void)
+{
+	uint32	key[3], logic[6];
+
+	for (int i = 0; i < 6; i++)
+		logic[i] = (!!PPU.ClipWindow1Enable[i]) | (!!PPU.ClipWindow2Enable[i] << 1) | (!!PPU.ClipWindow1Inside[i] << 2) | (!!PPU.ClipWindow2Inside[i] << 3) | ((PPU.ClipWindowOverlapLogic[i] & 3) << 4);
+
+	// The top bit of key[2] is always set, so an empty entry never matches
+	key[0] = PPU.Window1Left | (PPU.Window1Right << 8) | (PPU.Window2Left << 16) | (PPU.Window2Right << 24);
+	key[1] = logic[0] | (logic[1] << 6) | (logic[2] << 12) | (logic[3] << 18) | (logic[4] << 24);
+	key[2] = logic[5] | ((GFX.FillRAM[0x2130] & 0xf0) << 2) | (GFX.FillRAM[0x212e] << 12) | (GFX.FillRAM[0x212f] << 20) | ((Settings.DisableGraphicWindows ? 1 : 0) << 30) | 0x80000000;
+
+	uint32	h = (key[0] * 0x9e3779b1) ^ (key[1] * 0x85ebca6b) ^ (key[2] * 0xc2b2ae35);
+	struct ClipCacheEntry	*e = &ClipCache[(h ^ (h >> 16)) & (CLIP_CACHE_SIZE - 1)];
+
+	if (e->Key[0] == key[0] && e->Key[1] == key[1] && e->Key[2] == key[2])
+	{
+		memcpy(IPPU.Clip, e->Clip, sizeof(IPPU.Clip));
+		return;
+	}
+
+	ComputeClipWindows();
+
+	memcpy(e->Key,  key,       sizeof(e->Key));
+	memcpy(e->Clip, IPPU.Clip, sizeof(e->Clip));
+}
@@ -0,0 +1,353 @@
+/***********************************************************************************
+  Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+
+  (c) Copyright 1996 - 2002  Gary Henderson (gary.henderson@ntlworld.com),
+                             Jerremy Koot (jkoot@snes9x.com)
+
+  (c) Copyright 2002 - 2004  Matthew Kendora
+
+  (c) Copyright 2002 - 2005  Peter Bortas (peter@bortas.org)
+
+  (c) Copyright 2004 - 2005  Joel Yliluoma (http://iki.fi/bisqwit/)
+
+  (c) Copyright 2001 - 2006  John Weidman (jweidman@slip.net)
+
+  (c) Copyright 2002 - 2006  funkyass (funkyass@spam.shaw.ca),
+                             Kris Bleakley (codeviolation@hotmail.com)
+
+  (c) Copyright 2002 - 2010  Brad Jorsch (anomie@users.sourceforge.net),
+                             Nach (n-a-c-h@users.sourceforge.net),
+
+  (c) Copyright 2002 - 2011  zones (kasumitokoduck@yahoo.com)
+
+  (c) Copyright 2006 - 2007  nitsuja
+
+  (c) Copyright 2009 - 2011  BearOso,
+                             OV2
+
+
+  BS-X C emulator code
+  (c) Copyright 2005 - 2006  Dreamer Nom,
+                             zones
+
+  C4 x86 assembler and some C emulation code
+  (c) Copyright 2000 - 2003  _Demo_ (_demo_@zsnes.com),
+                             Nach,
+                             zsKnight (zsknight@zsnes.com)
+
+  C4 C++ code
+  (c) Copyright 2003 - 2006  Brad Jorsch,
+                             Nach
+
+  DSP-1 emulator code
+  (c) Copyright 1998 - 2006  _Demo_,
+                             Andreas Naive (andreasnaive@gmail.com),
+                             Gary Henderson,
+                             Ivar (ivar@snes9x.com),
+                             John Weidman,
+                             Kris Bleakley,
+                             Matthew Kendora,
+                             Nach,
+                             neviksti (neviksti@hotmail.com)
+
+  DSP-2 emulator code
+  (c) Copyright 2003         John Weidman,
+                             Kris Bleakley,
+                             Lord Nightmare (lord_nightmare@users.sourceforge.net),
+                             Matthew Kendora,
+                             neviksti
+
+  DSP-3 emulator code
+  (c) Copyright 2003 - 2006  John Weidman,
+                             Kris Bleakley,
+                             Lancer,
+                             z80 gaiden
+
+  DSP-4 emulator code
+  (c) Copyright 2004 - 2006  Dreamer Nom,
+                             John Weidman,
+                             Kris Bleakley,
+                             Nach,
+                             z80 gaiden
+
+  OBC1 emulator code
+  (c) Copyright 2001 - 2004  zsKnight,
+                             pagefault (pagefault@zsnes.com),
+                             Kris Bleakley
+                             Ported from x86 assembler to C by sanmaiwashi
+
+  SPC7110 and RTC C++ emulator code used in 1.39-1.51
+  (c) Copyright 2002         Matthew Kendora with research by
+                             zsKnight,
+                             John Weidman,
+                             Dark Force
+
+  SPC7110 and RTC C++ emulator code used in 1.52+
+  (c) Copyright 2009         byuu,
+                             neviksti
+
+  S-DD1 C emulator code
+  (c) Copyright 2003         Brad Jorsch with research by
+                             Andreas Naive,
+                             John Weidman
+
+  S-RTC C emulator code
+  (c) Copyright 2001 - 2006  byuu,
+                             John Weidman
+
+  ST010 C++ emulator code
+  (c) Copyright 2003         Feather,
+                             John Weidman,
+                             Kris Bleakley,
+                             Matthew Kendora
+
+  Super FX x86 assembler emulator code
+  (c) Copyright 1998 - 2003  _Demo_,
+                             pagefault,
+                             zsKnight
+
+  Super FX C emulator code
+  (c) Copyright 1997 - 1999  Ivar,
+                             Gary Henderson,
+                             John Weidman
+
+  Sound emulator code used in 1.5-1.51
+  (c) Copyright 1998 - 2003  Brad Martin
+  (c) Copyright 1998 - 2006  Charles Bilyue'
+
+  Sound emulator code used in 1.52+
+  (c) Copyright 2004 - 2007  Shay Green (gblargg@gmail.com)
+
+  SH assembler code partly based on x86 assembler code
+  (c) Copyright 2002 - 2004  Marcus Comstedt (marcus@mc.pp.se)
+
+  2xSaI filter
+  (c) Copyright 1999 - 2001  Derek Liauw Kie Fa
+
+  HQ2x, HQ3x, HQ4x filters
+  (c) Copyright 2003         Maxim Stepin (maxim@hiend3d.com)
+
+  NTSC filter
+  (c) Copyright 2006 - 2007  Shay Green
+
+  GTK+ GUI code
+  (c) Copyright 2004 - 2011  BearOso
+
+  Win32 GUI code
+  (c) Copyright 2003 - 2006  blip,
+                             funkyass,
+                             Matthew Kendora,
+                             Nach,
+                             nitsuja
+  (c) Copyright 2009 - 2011  OV2
+
+  Mac OS GUI code
+  (c) Copyright 1998 - 2001  John Stiles
+  (c) Copyright 2001 - 2011  zones
+
+
+  Specific ports contains the works of other authors. See headers in
+  individual files.
+
+
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute Snes9x in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  Snes9x is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for Snes9x or software derived from
+  Snes9x, including Snes9x or derivatives in commercial game bundles, and/or
+  using Snes9x as a promotion for your commercial product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ ***********************************************************************************/
+
+
+
+#include "snes9x.h"
+#include "memmap.h"
+#include "dma.h"
+#include "apu/apu.h"
+#include "gfx.h"
+#include "fxinst.h"
+#include "fxemu.h"
+#include "sa1.h"
+#include "seta.h"
+#include "spc7110.h"
+#include "srtc.h"
+#include "bsx.h"
+#include "obc1.h"
+#include "cheats.h"
+#include "consolestate.h"
+
+extern uint8					*HDMAMemPointers[8];
+
+struct S9xConsoleState
+{
+	SAPUContext				*APU;
+
+	CMemory					Memory;
+	struct SMulti			Multi;
+	struct SSettings		Settings;
+	struct SSNESGameFixes	SNESGameFixes;
+
+	struct SCPUState		CPU;
+	struct SICPU			ICPU;
+	struct SIdleLoop		IdleLoop;
+	struct SRegisters		Registers;
+	struct STimings			Timings;
+	struct SDMA				DMA[8];
+	uint8					*HDMAMemPointers[8];
+	uint8					OpenBus;
+	SnesModel				*Model;
+
+	struct SPPU				PPU;
+	struct InternalPPU		IPPU;
+	struct SGFX				GFX;
+	struct SBG				BG;
+	struct SLineData		LineData[240];
+	struct SLineMatrixData	LineMatrixData[240];
+
+	struct SSA1				SA1;
+	struct SSA1Registers	SA1Registers;
+	uint8					SA1OpenBus;
+	struct FxRegs_s			GSU;
+	struct FxInfo_s			SuperFX;
+	struct SDSP0			DSP0;
+	struct SDSP1			DSP1;
+	struct SDSP2			DSP2;
+	struct SDSP3			DSP3;
+	struct SDSP4			DSP4;
+	struct SST010			ST010;
+	struct SST011			ST011;
+	struct SST018			ST018;
+	uint8					(*GetSETA) (uint32);
+	void					(*SetSETA) (uint32, uint8);
+	struct SOBC1			OBC1;
+	struct SSPC7110Snapshot	s7snap;
+	struct SSRTCSnapshot	srtcsnap;
+	struct SRTCData			RTCData;
+	struct SBSX				BSX;
+
+	struct SCheatData		Cheat;
+	struct Watch			watches[16];
+};
+
+static S9xConsoleState	*active = NULL;
+
+static S9xConsoleState * NewState (void);
+static void SaveState (S9xConsoleState *);
+static void LoadState (S9xConsoleState *);
+
+
+static S9xConsoleState * NewState (void)
+{
+	S9xConsoleState	*state = (S9xConsoleState *) calloc(1, sizeof(S9xConsoleState));
+	if (!state)
+		return (NULL);
+
+	state->APU = S9xAPUNewContext();
+
+	return (state);
+}
+
+#define SAVE(v)			memcpy(&state->v, &v, sizeof(v))
+#define LOAD(v)			memcpy(&v, &state->v, sizeof(v))
+#define TRANSFER(X) \
+	X(Memory); X(Multi); X(Settings); X(SNESGameFixes); \
+	X(CPU); X(ICPU); X(IdleLoop); X(Registers); X(Timings); X(DMA); X(HDMAMemPointers); X(OpenBus); X(Model); \
+	X(PPU); X(IPPU); X(GFX); X(BG); X(LineData); X(LineMatrixData); \
+	X(SA1); X(SA1Registers); X(SA1OpenBus); X(GSU); X(SuperFX); \
+	X(DSP0); X(DSP1); X(DSP2); X(DSP3); X(DSP4); X(ST010); X(ST011); X(ST018); X(GetSETA); X(SetSETA); \
+	X(OBC1); X(s7snap); X(srtcsnap); X(RTCData); X(BSX); \
+	X(Cheat); X(watches)
+
+static void SaveState (S9xConsoleState *state)
+{
+	TRANSFER(SAVE);
+	S9xAPUSaveContext(state->APU);
+}
+
+static void LoadState (S9xConsoleState *state)
+{
+	TRANSFER(LOAD);
+	S9xAPULoadContext(state->APU);
+}
+
+#undef SAVE
+#undef LOAD
+#undef TRANSFER
+
+S9xConsoleState * S9xCurrentConsoleState (void)
+{
+	// The state that exists before any other is restored becomes the first one.
+	if (!active)
+		active = NewState();
+
+	return (active);
+}
+
+bool8 S9xConsoleStatesSupported (void)
+{
+	return (Settings.RenderThreads <= 1 && !Settings.PipelinedRendering && !Settings.ReuseUnchangedLines);
+}
+
+S9xConsoleState * S9xNewConsoleState (void)
+{
+	if (!S9xConsoleStatesSupported())
+		return (NULL);
+
+	S9xConsoleState	*state = NewState();
+	if (!state)
+		return (NULL);
+
+	S9xCurrentConsoleState();
+
+	state->Settings = Settings;
+	state->Model    = &M1SNES;
+
+	return (state);
+}
+
+bool8 S9xFreeConsoleState (S9xConsoleState *state)
+{
+	S9xConsoleState	*prev = S9xCurrentConsoleState();
+
+	if (state == prev)
+		return (FALSE);
+
+	// Let the usual teardown free what the console owns.
+	S9xRestoreConsoleState(state);
+	S9xGraphicsDeinit();
+	S9xDeinitAPU();
+	Memory.Deinit();
+	S9xRestoreConsoleState(prev);
+
+	S9xAPUDeleteContext(state->APU);
+	free(state);
+
+	return (TRUE);
+}
+
+void S9xRestoreConsoleState (S9xConsoleState *state)
+{
+	if (state == S9xCurrentConsoleState())
+		return;
+
+	SaveState(active);
+	LoadState(state);
+	active = state;
+}
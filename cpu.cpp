@@ -222,6 +222,8 @@ static void S9xSoftResetCPU (void)
 	CPU.MemSpeed = SLOW_ONE_CYCLE;
 	CPU.MemSpeedx2 = SLOW_ONE_CYCLE * 2;
 	CPU.FastROMSpeed = SLOW_ONE_CYCLE;
+	Memory.map_PageSpeeds();
+	IdleLoop.Decoded = IdleLoop.Seen = FALSE;
 	CPU.InDMA = FALSE;
 	CPU.InHDMA = FALSE;
 	CPU.InDMAorHDMA = FALSE;
@@ -230,6 +232,7 @@ static void S9xSoftResetCPU (void)
 	CPU.CurrentDMAorHDMAChannel = -1;
 	CPU.WhichEvent = HC_RENDER_EVENT;
 	CPU.NextEvent  = Timings.RenderPos;
+	CPU.NextIRQTimerCheck = 0;
 	CPU.WaitingForInterrupt = FALSE;
 	CPU.AutoSaveTimer = 0;
 	CPU.SRAMModified = FALSE;
@@ -189,12 +189,26 @@
 #endif
 
 static inline void S9xReschedule (void);
+template <bool8 SA1Sliced> static inline void S9xRunBlock (void);
 
 
-void S9xMainLoop (void)
+// One main loop per kind of cartridge, so that the per-instruction SA-1 test
+// is resolved at compile time. S9xSelectMainLoop picks one when a ROM is
+// loaded. With SA1Sliced, the SA-1 step after each instruction is only
+// counted, and S9xSA1Sync runs the count before the S-CPU reaches anything
+// shared with the SA-1 and at every H event. With Blocks, straight-line code
+// is run by S9xRunBlock (Settings.BlockDispatch).
+
+template <bool8 SA1Cart, bool8 SA1Sliced, bool8 Blocks>
+static void S9xRunMainLoop (void)
 {
 	for (;;)
 	{
+	#ifndef DEBUGGER
+		if (Blocks && CPU.PCBase && (!SA1Cart || SA1Sliced))
+			S9xRunBlock<SA1Sliced>();
+	#endif
+
 		if (CPU.NMILine)
 		{
 			if (Timings.NMITriggerPos <= CPU.Cycles)
@@ -207,6 +221,7 @@ void S9xMainLoop (void)
 					Registers.PCw++;
 				}
 
+				IdleLoop.Seen = FALSE;
 				S9xOpcode_NMI();
 			}
 		}
@@ -227,7 +242,10 @@ void S9xMainLoop (void)
 				CPU.IRQPending = Timings.IRQPendCount;
 
 				if (!CheckFlag(IRQ))
+				{
+					IdleLoop.Seen = FALSE;
 					S9xOpcode_IRQ();
+				}
 			}
 		}
 
@@ -294,10 +312,16 @@ void S9xMainLoop (void)
 		Registers.PCw++;
 		(*Opcodes[Op].S9xOpcode)();
 
-		if (Settings.SA1)
+		if (SA1Sliced)
+			SA1.PendingSteps++;
+		else
+		if (SA1Cart)
 			S9xSA1MainLoop();
 	}
 
+	if (SA1Sliced)
+		S9xSA1Sync();
+
 	S9xPackStatus();
 
 	if (CPU.Flags & SCAN_KEYS_FLAG)
@@ -310,6 +334,247 @@ void S9xMainLoop (void)
 	}
 }
 
+void S9xSelectMainLoop (void)
+{
+	if (Settings.SA1 && Settings.SA1TimeSlice)
+		ICPU.S9xMainLoop = Settings.BlockDispatch ? S9xRunMainLoop<TRUE, TRUE, TRUE> : S9xRunMainLoop<TRUE, TRUE, FALSE>;
+	else
+	if (Settings.SA1)
+		ICPU.S9xMainLoop = S9xRunMainLoop<TRUE, FALSE, FALSE>;
+	else
+		ICPU.S9xMainLoop = Settings.BlockDispatch ? S9xRunMainLoop<FALSE, FALSE, TRUE> : S9xRunMainLoop<FALSE, FALSE, FALSE>;
+}
+
+void S9xMainLoop (void)
+{
+	(*ICPU.S9xMainLoop)();
+}
+
+// Runs straight-line code inside the current memory map block. While no
+// interrupt line is up and SCAN_KEYS_FLAG is clear, the checks at the top of
+// S9xMainLoop do nothing, and an instruction that starts more than 4 bytes
+// before the end of the block cannot cross into the next one, so the fetch
+// and dispatch can skip both. Leaves as soon as any of that stops being true.
+// This is not a trace cache: the opcode handlers read their own operands
+// through CPU.PCBase and the handler table follows the M and X flags, so
+// pre-decoded handlers and operands could not be used without rewriting
+// cpuops. Code bytes are still read on every pass, so writes to RAM code need
+// no invalidation.
+
+template <bool8 SA1Sliced>
+static inline void S9xRunBlock (void)
+{
+	uint8	*PCBase = CPU.PCBase;
+
+	while (!CPU.NMILine && !CPU.IRQTransition && !CPU.IRQExternal && !(CPU.Flags & SCAN_KEYS_FLAG) &&
+		CPU.PCBase == PCBase && (Registers.PCw & MEMMAP_MASK) < MEMMAP_BLOCK_SIZE - 4)
+	{
+		uint8	Op = PCBase[Registers.PCw];
+
+		CPU.PrevCycles = CPU.Cycles;
+		CPU.Cycles += CPU.MemSpeed;
+		S9xCheckInterrupts();
+
+		Registers.PCw++;
+		(*ICPU.S9xOpcodes[Op].S9xOpcode)();
+
+		if (SA1Sliced)
+			SA1.PendingSteps++;
+	}
+}
+
+// Idle loops. A loop that only reads memory or $4210-$4212, compares and
+// branches back, and starts each pass with the same registers, goes through
+// the same passes until the next H event or /IRQ timer position: nothing it
+// reads can change before then. Once two passes in a row have shown the
+// length of one, whole passes are skipped by moving CPU.Cycles ahead, so that
+// the loop is left at exactly the cycle it would have been anyway.
+
+static bool8 IdleLoopReadIsSafe (uint32 Address)
+{
+	int	block = (Address & 0xffffff) >> MEMMAP_SHIFT;
+
+	if (Memory.Page[block].Read)
+		return (TRUE);
+
+	if (Memory.Map[block] != (uint8 *) CMemory::MAP_CPU)
+		return (FALSE);
+
+	switch (Address & 0xffff)
+	{
+		case 0x4210: // RDNMI, unchanged once read
+			IdleLoop.ReadsRDNMI = TRUE;
+			return (TRUE);
+
+		case 0x4211: // TIMEUP, unchanged while /IRQ is high
+			return (TRUE);
+
+		case 0x4212: // HVBJOY
+			IdleLoop.ReadsHVBJOY = TRUE;
+			return (TRUE);
+	}
+
+	return (FALSE);
+}
+
+static void DecodeIdleLoop (uint32 Start, uint32 End)
+{
+	IdleLoop.Start = Start;
+	IdleLoop.End = End;
+	IdleLoop.PCBase = CPU.PCBase;
+	IdleLoop.DirectPage = Registers.D.W;
+	IdleLoop.DataBank = Registers.DB;
+	IdleLoop.WidthFlags = Registers.PL & (MemoryFlag | IndexFlag);
+	IdleLoop.V_Counter = CPU.V_Counter;
+	IdleLoop.WhichEvent = CPU.WhichEvent;
+	IdleLoop.Decoded = TRUE;
+	IdleLoop.Safe = FALSE;
+	IdleLoop.ReadsRDNMI = FALSE;
+	IdleLoop.ReadsHVBJOY = FALSE;
+	IdleLoop.Seen = FALSE;
+
+	uint16	pc = Start & 0xffff, end = End & 0xffff;
+
+	if (!CPU.PCBase || end - pc > 32 || ((pc ^ (end - 1)) & ~MEMMAP_MASK))
+		return;
+
+	while (pc < end)
+	{
+		uint8	op = CPU.PCBase[pc];
+		uint8	*operand = CPU.PCBase + pc + 1;
+		int		len = ICPU.S9xOpLengths[op];
+		uint32	address;
+		bool8	wide;
+
+		if (pc + len > end)
+			return;
+
+		switch (op)
+		{
+			// NOP, CLC, SEC, shifts of A and immediate operands
+			case 0xea: case 0x18: case 0x38: case 0x0a: case 0x4a: case 0x2a: case 0x6a:
+			case 0xa9: case 0xc9: case 0x29: case 0x09: case 0x49: case 0x89:
+			case 0xa2: case 0xa0: case 0xe0: case 0xc0:
+				break;
+
+			// LDA, CMP, AND, ORA, EOR, BIT dp and LDX, LDY, CPX, CPY dp
+			case 0xa5: case 0xc5: case 0x25: case 0x05: case 0x45: case 0x24:
+			case 0xa6: case 0xa4: case 0xe4: case 0xc4:
+				wide = (op & 0x03) == 0x01 || op == 0x24 ? !CheckMemory() : !CheckIndex();
+				address = (Registers.D.W + operand[0]) & 0xffff;
+				if (!IdleLoopReadIsSafe(address) || (wide && !IdleLoopReadIsSafe((address + 1) & 0xffff)))
+					return;
+				break;
+
+			// the same with absolute addresses
+			case 0xad: case 0xcd: case 0x2d: case 0x0d: case 0x4d: case 0x2c:
+			case 0xae: case 0xac: case 0xec: case 0xcc:
+				wide = (op & 0x03) == 0x01 || op == 0x2c ? !CheckMemory() : !CheckIndex();
+				address = ICPU.ShiftedDB + (operand[0] | (operand[1] << 8));
+				if (!IdleLoopReadIsSafe(address) || (wide && !IdleLoopReadIsSafe(address + 1)))
+					return;
+				break;
+
+			// LDA, CMP, AND, ORA, EOR long
+			case 0xaf: case 0xcf: case 0x2f: case 0x0f: case 0x4f:
+				address = operand[0] | (operand[1] << 8) | (operand[2] << 16);
+				if (!IdleLoopReadIsSafe(address) || (!CheckMemory() && !IdleLoopReadIsSafe(address + 1)))
+					return;
+				break;
+
+			// Branches must stay inside the loop, so that the only way out is
+			// falling through the closing one.
+			case 0x10: case 0x30: case 0x50: case 0x70: case 0x90: case 0xb0: case 0xd0: case 0xf0: case 0x80:
+			{
+				uint16	target = pc + 2 + (int8) operand[0];
+				if (target < (Start & 0xffff) || target >= end)
+					return;
+				break;
+			}
+
+			default:
+				return;
+		}
+
+		pc += len;
+	}
+
+	IdleLoop.Safe = (pc == end);
+}
+
+// Where the CPU can be moved ahead to without missing anything, or 0 if an
+// interrupt or the end of the frame is already pending.
+static int32 IdleLoopBound (bool8 hvbjoy)
+{
+	if (CPU.NMILine || CPU.IRQLine || CPU.IRQLastState || CPU.IRQTransition || CPU.IRQExternal || (CPU.Flags & SCAN_KEYS_FLAG))
+		return (0);
+
+	int32	bound = CPU.NextEvent;
+
+	if (CPU.NextIRQTimerCheck < bound)
+		bound = CPU.NextIRQTimerCheck;
+
+	if (hvbjoy && CPU.Cycles < Timings.HBlankEnd && Timings.HBlankEnd < bound)
+		bound = Timings.HBlankEnd;
+
+	return (bound);
+}
+
+static void SkipIdleCycles (int32 period, int32 bound)
+{
+	if (period <= 0 || bound <= CPU.Cycles)
+		return;
+
+	int32	skip = (bound - 1 - CPU.Cycles) / period * period;
+
+	CPU.Cycles += skip;
+	CPU.PrevCycles += skip;
+	IdleLoop.Skipped += skip;
+}
+
+// Called when a branch ending at Registers.PCw is about to go back to Start.
+void S9xCheckIdleLoop (uint16 Start)
+{
+	uint32	start = ICPU.ShiftedPB | Start;
+	uint32	end = ICPU.ShiftedPB | Registers.PCw;
+
+	if (!IdleLoop.Seen || start != IdleLoop.Start || end != IdleLoop.End || CPU.PCBase != IdleLoop.PCBase ||
+		Registers.D.W != IdleLoop.DirectPage || Registers.DB != IdleLoop.DataBank || (Registers.PL & (MemoryFlag | IndexFlag)) != IdleLoop.WidthFlags ||
+		CPU.V_Counter != IdleLoop.V_Counter || CPU.WhichEvent != IdleLoop.WhichEvent)
+		DecodeIdleLoop(start, end);
+
+	if (!IdleLoop.Safe)
+		return;
+
+	int32	bound = IdleLoopBound(IdleLoop.ReadsHVBJOY);
+
+	if (IdleLoop.Seen && bound &&
+		CPU.Cycles > IdleLoop.Cycles && CPU.Cycles - IdleLoop.Cycles < Timings.H_Max &&
+		(!IdleLoop.ReadsHVBJOY || (CPU.Cycles < Timings.HBlankEnd) == (IdleLoop.Cycles < Timings.HBlankEnd)) &&
+		Registers.P.W == IdleLoop.Registers.P.W && Registers.A.W == IdleLoop.Registers.A.W &&
+		Registers.X.W == IdleLoop.Registers.X.W && Registers.Y.W == IdleLoop.Registers.Y.W &&
+		Registers.S.W == IdleLoop.Registers.S.W && OpenBus == IdleLoop.OpenBus &&
+		ICPU._Carry == IdleLoop.Flags[0] && ICPU._Zero == IdleLoop.Flags[1] &&
+		ICPU._Negative == IdleLoop.Flags[2] && ICPU._Overflow == IdleLoop.Flags[3])
+		SkipIdleCycles(CPU.Cycles - IdleLoop.Cycles, bound);
+
+	IdleLoop.Seen = bound && !(IdleLoop.ReadsRDNMI && (Memory.FillRAM[0x4210] & 0x80));
+	IdleLoop.Cycles = CPU.Cycles;
+	IdleLoop.OpenBus = OpenBus;
+	IdleLoop.Registers = Registers;
+	IdleLoop.Flags[0] = ICPU._Carry;
+	IdleLoop.Flags[1] = ICPU._Zero;
+	IdleLoop.Flags[2] = ICPU._Negative;
+	IdleLoop.Flags[3] = ICPU._Overflow;
+}
+
+// Called after WAI, which repeats itself until an interrupt comes.
+void S9xSkipIdleWait (void)
+{
+	if (CPU.PCBase)
+		SkipIdleCycles(CPU.MemSpeed + TWO_CYCLES, IdleLoopBound(FALSE));
+}
+
 static inline void S9xReschedule (void)
 {
 	switch (CPU.WhichEvent)
@@ -367,6 +632,8 @@ void S9xDoHEventProcessing (void)
 			eventname[CPU.WhichEvent], CPU.NextEvent, CPU.Cycles);
 #endif
 
+	S9xSA1Sync();
+
 	switch (CPU.WhichEvent)
 	{
 		case HC_HBLANK_START_EVENT:
@@ -397,7 +664,7 @@ void S9xDoHEventProcessing (void)
 			S9xAPUEndScanline();
 			CPU.Cycles -= Timings.H_Max;
 			CPU.PrevCycles -= Timings.H_Max;
-			S9xAPUSetReferenceTime(CPU.Cycles);
+			S9xAPUShiftReferenceTime(-Timings.H_Max);
 
 			if ((Timings.NMITriggerPos != 0xffff) && (Timings.NMITriggerPos >= Timings.H_Max))
 				Timings.NMITriggerPos -= Timings.H_Max;
@@ -444,6 +711,8 @@ void S9xDoHEventProcessing (void)
 			else
 				Timings.H_Max = Timings.H_Max_Master;					// HC=1364
 
+			S9xUpdateIRQTimerCheck();
+
 			if (Model->_5A22 == 2)
 			{
 				if (CPU.V_Counter != 240 || IPPU.Interlace || !Timings.InterlaceField)	// V=240
@@ -193,6 +193,7 @@ struct SICPU
 {
 	struct SOpcodes	*S9xOpcodes;
 	uint8	*S9xOpLengths;
+	void	(*S9xMainLoop) (void);
 	uint8	_Carry;
 	uint8	_Zero;
 	uint8	_Negative;
@@ -205,6 +206,32 @@ struct SICPU
 
 extern struct SICPU		ICPU;
 
+// The loop S9xCheckIdleLoop is watching, and the state at its start the last
+// time its closing branch was taken.
+struct SIdleLoop
+{
+	uint32	Start;			// PB:PC of the first instruction
+	uint32	End;			// PB:PC after the closing branch
+	uint8	*PCBase;		// the decode below holds for this mapping,
+	uint16	DirectPage;		// direct page,
+	uint8	DataBank;		// data bank
+	uint8	WidthFlags;		// and M/X flags
+	bool8	Decoded;
+	bool8	Safe;			// only reads that cannot change before the next event
+	bool8	ReadsRDNMI;		// $4210 only holds still once its flag is clear
+	bool8	ReadsHVBJOY;	// $4212 also changes at the end of H-blank
+	bool8	Seen;			// whether the fields below are valid
+	int32	Cycles;
+	int32	V_Counter;
+	uint8	WhichEvent;
+	uint8	OpenBus;
+	uint8	Flags[4];
+	struct SRegisters	Registers;
+	uint64	Skipped;		// master cycles fast-forwarded since power on
+};
+
+extern struct SIdleLoop	IdleLoop;
+
 extern struct SOpcodes	S9xOpcodesE1[256];
 extern struct SOpcodes	S9xOpcodesM1X1[256];
 extern struct SOpcodes	S9xOpcodesM1X0[256];
@@ -217,9 +244,12 @@ extern uint8			S9xOpLengthsM0X1[256];
 extern uint8			S9xOpLengthsM0X0[256];
 
 void S9xMainLoop (void);
+void S9xSelectMainLoop (void);
 void S9xReset (void);
 void S9xSoftReset (void);
 void S9xDoHEventProcessing (void);
+void S9xCheckIdleLoop (uint16);
+void S9xSkipIdleWait (void);
 
 static inline void S9xUnpackStatus (void)
 {
@@ -271,8 +301,39 @@ static inline void S9xFixCycles (void)
 	}
 }
 
+// Earliest CPU.Cycles in the current scanline at which the H/V timers can
+// raise /IRQ. Until then, as long as /IRQ is not held low (IRQLine) and was
+// not asserted by the last check (IRQLastState), S9xCheckInterrupts would
+// change nothing, so it returns at once. Recompute whenever V_Counter, H_Max
+// or the timer registers change.
+
+static inline void S9xUpdateIRQTimerCheck (void)
+{
+	int32	pos = 0x7fffffff;
+
+	if (PPU.HTimerEnabled)
+	{
+		if (!PPU.VTimerEnabled || CPU.V_Counter == PPU.VTimerPosition || CPU.V_Counter + 1 == PPU.VTimerPosition)
+			pos = PPU.HTimerPosition;
+	}
+	else
+	if (PPU.VTimerEnabled)
+	{
+		if (CPU.V_Counter == PPU.VTimerPosition)
+			pos = 0;
+		else
+		if (CPU.V_Counter + 1 == PPU.VTimerPosition)
+			pos = Timings.H_Max;
+	}
+
+	CPU.NextIRQTimerCheck = pos;
+}
+
 static inline void S9xCheckInterrupts (void)
 {
+	if (CPU.Cycles < CPU.NextIRQTimerCheck && !CPU.IRQLine && !CPU.IRQLastState)
+		return;
+
 	bool8	thisIRQ = PPU.HTimerEnabled || PPU.VTimerEnabled;
 
 	if (CPU.IRQLine && thisIRQ)
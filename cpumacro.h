@@ -280,8 +280,13 @@ static void Op##OP (void) \
 		if ((Registers.PCw & ~MEMMAP_MASK) != (newPC.W & ~MEMMAP_MASK)) \
 			S9xSetPCBase(ICPU.ShiftedPB + newPC.W); \
 		else \
+		{ \
+			IdleLoopTaken(newPC.W); \
 			Registers.PCw = newPC.W; \
+		} \
 	} \
+	else \
+		IdleLoopNotTaken(); \
 }
 
 
@@ -194,6 +194,16 @@
 #define AddCycles(n)	{ CPU.PrevCycles = CPU.Cycles; CPU.Cycles += (n); S9xCheckInterrupts(); while (CPU.Cycles >= CPU.NextEvent) S9xDoHEventProcessing(); }
 #endif
 
+// A taken backward branch may close an idle loop, and falling through the
+// closing branch of the one being watched leaves it.
+#if defined(SA1_OPCODES) || defined(DEBUGGER)
+#define IdleLoopTaken(target)	((void) 0)
+#define IdleLoopNotTaken()	((void) 0)
+#else
+#define IdleLoopTaken(target)	{ if (Settings.SkipIdleLoops && (target) < Registers.PCw) S9xCheckIdleLoop(target); }
+#define IdleLoopNotTaken()	{ if (IdleLoop.Seen && (ICPU.ShiftedPB | Registers.PCw) == IdleLoop.End) IdleLoop.Seen = FALSE; }
+#endif
+
 #include "cpuaddr.h"
 #include "cpuops.h"
 #include "cpumacro.h"
@@ -3467,6 +3477,10 @@ static void OpCB (void)
 	CPU.WaitingForInterrupt = TRUE;
 	Registers.PCw--;
 	AddCycles(TWO_CYCLES);
+#ifndef DEBUGGER
+	if (Settings.SkipIdleLoops)
+		S9xSkipIdleWait();
+#endif
 #endif
 }
 
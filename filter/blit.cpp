@@ -191,8 +191,10 @@ static uint32	colorMask = 0;
 #define colorMask		(((~RGB_HI_BITS_MASK & ALL_COLOR_MASK) << 16) | (~RGB_HI_BITS_MASK & ALL_COLOR_MASK))
 #endif
 
-static snes_ntsc_t	*ntsc   = NULL;
 static uint8		*XDelta = NULL;
+#if PIXEL_BITS == 16
+static snes_ntsc_t	*ntsc   = NULL;
+#endif
 
 
 bool8 S9xBlitFilterInit (void)
@@ -231,6 +233,8 @@ void S9xBlitClearDelta (void)
 			*d++ = 0x80008000;
 }
 
+#if PIXEL_BITS == 16
+
 bool8 S9xBlitNTSCFilterInit (void)
 {
 	ntsc = (snes_ntsc_t *) malloc(sizeof(snes_ntsc_t));
@@ -255,9 +259,14 @@ void S9xBlitNTSCFilterSet (const snes_ntsc_setup_t *setup)
 	snes_ntsc_init(ntsc, setup);
 }
 
+#endif
+
+// The Simple blitters copy pixels whatever their size, so they also serve XRGB8888 builds.
+// The rest only know 16-bit pixels.
+
 void S9xBlitPixSimple1x1 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
-	width <<= 1;
+	width *= sizeof(pixel_t);
 
 	for (; height; height--)
 	{
@@ -269,7 +278,7 @@ void S9xBlitPixSimple1x1 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dst
 
 void S9xBlitPixSimple1x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
-	width <<= 1;
+	width *= sizeof(pixel_t);
 
 	for (; height; height--)
 	{
@@ -285,7 +294,7 @@ void S9xBlitPixSimple2x1 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dst
 {
 	for (; height; height--)
 	{
-		uint16	*dP = (uint16 *) dstPtr, *bP = (uint16 *) srcPtr;
+		pixel_t	*dP = (pixel_t *) dstPtr, *bP = (pixel_t *) srcPtr;
 
 		for (int i = 0; i < (width >> 1); i++)
 		{
@@ -301,6 +310,28 @@ void S9xBlitPixSimple2x1 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dst
 	}
 }
 
+#if PIXEL_BITS == 32
+
+void S9xBlitPixSimple2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
+{
+	uint8	*dstPtr2 = dstPtr + dstRowBytes;
+	dstRowBytes <<= 1;
+
+	for (; height; height--)
+	{
+		uint32	*dP1 = (uint32 *) dstPtr, *dP2 = (uint32 *) dstPtr2, *bP = (uint32 *) srcPtr;
+
+		for (int i = 0; i < width; i++, bP++, dP1 += 2, dP2 += 2)
+			dP1[0] = dP1[1] = dP2[0] = dP2[1] = *bP;
+
+		srcPtr  += srcRowBytes;
+		dstPtr  += dstRowBytes;
+		dstPtr2 += dstRowBytes;
+	}
+}
+
+#else
+
 void S9xBlitPixSimple2x2 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int dstRowBytes, int width, int height)
 {
 	uint8	*dstPtr2 = dstPtr + dstRowBytes, *deltaPtr = XDelta;
@@ -711,3 +742,5 @@ void S9xBlitPixHiResNTSC16 (uint8 *srcPtr, int srcRowBytes, uint8 *dstPtr, int d
 {
 	snes_ntsc_blit_hires(ntsc, (SNES_NTSC_IN_T const *) srcPtr, srcRowBytes >> 1, 0, width, height, dstPtr, dstRowBytes);
 }
+
+#endif
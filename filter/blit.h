@@ -179,21 +179,26 @@
 #ifndef _blit_h_
 #define _blit_h_
 
+#if PIXEL_BITS == 16
 #include "2xsai.h"
 #include "epx.h"
 #include "hq2x.h"
 #include "snes_ntsc.h"
+#endif
 
 bool8 S9xBlitFilterInit (void);
 void S9xBlitFilterDeinit (void);
 void S9xBlitClearDelta (void);
-bool8 S9xBlitNTSCFilterInit (void);
-void S9xBlitNTSCFilterDeinit (void);
-void S9xBlitNTSCFilterSet (const snes_ntsc_setup_t *);
 void S9xBlitPixSimple1x1 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixSimple1x2 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixSimple2x1 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixSimple2x2 (uint8 *, int, uint8 *, int, int, int);
+
+// The other filters only exist in 16-bit pixel builds
+#if PIXEL_BITS == 16
+bool8 S9xBlitNTSCFilterInit (void);
+void S9xBlitNTSCFilterDeinit (void);
+void S9xBlitNTSCFilterSet (const snes_ntsc_setup_t *);
 void S9xBlitPixBlend1x1 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixBlend2x1 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixTV1x2 (uint8 *, int, uint8 *, int, int, int);
@@ -209,5 +214,6 @@ void S9xBlitPixHQ3x16 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixHQ4x16 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixNTSC16 (uint8 *, int, uint8 *, int, int, int);
 void S9xBlitPixHiResNTSC16 (uint8 *, int, uint8 *, int, int, int);
+#endif
 
 #endif
@@ -4137,10 +4137,16 @@ static void fx_sm_r15 (void)
 
 uint32 fx_run (uint32 nInstructions)
 {
+	uint32	vCounter = nInstructions;
+
+	// Only stop clears G, and it zeroes GSU.vCounter itself, so the count
+	// can stay in a register and be stored once the loop runs out.
 	GSU.vCounter = nInstructions;
 	READR14;
-	while (TF(G) && (GSU.vCounter-- > 0))
+	while (TF(G) && (vCounter-- > 0))
 		FX_STEP;
+	if (TF(G))
+		GSU.vCounter = vCounter;
 #if 0
 #ifndef FX_ADDRESS_CHECK
 	GSU.vPipeAdr = USEX16(R15 - 1) | (USEX8(GSU.vPrgBankReg) << 16);
@@ -231,105 +231,22 @@ static inline int32 memory_speed (uint32 address)
 
 inline uint8 S9xGetByte (uint32 Address)
 {
-	int		block = (Address & 0xffffff) >> MEMMAP_SHIFT;
-	uint8	*GetAddress = Memory.Map[block];
-	int32	speed = memory_speed(Address);
+	const struct SMemoryPage	*page = &Memory.Page[(Address & 0xffffff) >> MEMMAP_SHIFT];
+	int32	speed = page->Speed;
 	uint8	byte;
 
-	if (GetAddress >= (uint8 *) CMemory::MAP_LAST)
+	if (page->Read)
+		byte = *(page->Read + (Address & 0xffff));
+	else
 	{
-		byte = *(GetAddress + (Address & 0xffff));
-		addCyclesInMemoryAccess;
-		return (byte);
+		// Only I/O blocks have a speed that varies within the block.
+		if (!speed)
+			speed = memory_speed(Address);
+		byte = page->Get(Address);
 	}
 
-	switch ((pint) GetAddress)
-	{
-		case CMemory::MAP_CPU:
-			byte = S9xGetCPU(Address & 0xffff);
-			addCyclesInMemoryAccess;
-			return (byte);
-
-		case CMemory::MAP_PPU:
-			if (CPU.InDMAorHDMA && (Address & 0xff00) == 0x2100)
-				return (OpenBus);
-
-			byte = S9xGetPPU(Address & 0xffff);
-			addCyclesInMemoryAccess;
-			return (byte);
-
-		case CMemory::MAP_LOROM_SRAM:
-		case CMemory::MAP_SA1RAM:
-			// Address & 0x7fff   : offset into bank
-			// Address & 0xff0000 : bank
-			// bank >> 1 | offset : SRAM address, unbound
-			// unbound & SRAMMask : SRAM offset
-			byte = *(Memory.SRAM + ((((Address & 0xff0000) >> 1) | (Address & 0x7fff)) & Memory.SRAMMask));
-			addCyclesInMemoryAccess;
-			return (byte);
-
-		case CMemory::MAP_LOROM_SRAM_B:
-			byte = *(Multi.sramB + ((((Address & 0xff0000) >> 1) | (Address & 0x7fff)) & Multi.sramMaskB));
-			addCyclesInMemoryAccess;
-			return (byte);
-
-		case CMemory::MAP_HIROM_SRAM:
-		case CMemory::MAP_RONLY_SRAM:
-			byte = *(Memory.SRAM + (((Address & 0x7fff) - 0x6000 + ((Address & 0xf0000) >> 3)) & Memory.SRAMMask));
-			addCyclesInMemoryAccess;
-			return (byte);
-
-		case CMemory::MAP_BWRAM:
-			byte = *(Memory.BWRAM + ((Address & 0x7fff) - 0x6000));
-			addCyclesInMemoryAccess;
-			return (byte);
-
-		case CMemory::MAP_DSP:
-			byte = S9xGetDSP(Address & 0xffff);
-			addCyclesInMemoryAccess;
-			return (byte);
-
-		case CMemory::MAP_SPC7110_ROM:
-			byte = S9xGetSPC7110Byte(Address);
-			addCyclesInMemoryAccess;
-			return (byte);
-
-		case CMemory::MAP_SPC7110_DRAM:
-			byte = S9xGetSPC7110(0x4800);
-			addCyclesInMemoryAccess;
-			return (byte);
-
-		case CMemory::MAP_C4:
-			byte = S9xGetC4(Address & 0xffff);
-			addCyclesInMemoryAccess;
-			return (byte);
-
-		case CMemory::MAP_OBC_RAM:
-			byte = S9xGetOBC1(Address & 0xffff);
-			addCyclesInMemoryAccess;
-			return (byte);
-
-		case CMemory::MAP_SETA_DSP:
-			byte = S9xGetSetaDSP(Address);
-			addCyclesInMemoryAccess;
-			return (byte);
-
-		case CMemory::MAP_SETA_RISC:
-			byte = S9xGetST018(Address);
-			addCyclesInMemoryAccess;
-			return (byte);
-
-		case CMemory::MAP_BSX:
-			byte = S9xGetBSX(Address);
-			addCyclesInMemoryAccess;
-			return (byte);
-
-		case CMemory::MAP_NONE:
-		default:
-			byte = OpenBus;
-			addCyclesInMemoryAccess;
-			return (byte);
-	}
+	addCyclesInMemoryAccess;
+	return (byte);
 }
 
 inline uint16 S9xGetWord (uint32 Address, enum s9xwrap_t w = WRAP_NONE)
@@ -360,18 +277,28 @@ inline uint16 S9xGetWord (uint32 Address, enum s9xwrap_t w = WRAP_NONE)
 	}
 
 	int		block = (Address & 0xffffff) >> MEMMAP_SHIFT;
-	uint8	*GetAddress = Memory.Map[block];
-	int32	speed = memory_speed(Address);
+	const struct SMemoryPage	*page = &Memory.Page[block];
+	int32	speed = page->Speed;
 	uint16	word;
 
-	if (GetAddress >= (uint8 *) CMemory::MAP_LAST)
+	if (page->Read)
 	{
-		word = READ_WORD(GetAddress + (Address & 0xffff));
+		word = READ_WORD(page->Read + (Address & 0xffff));
 		addCyclesInMemoryAccess_x2;
 		return (word);
 	}
 
-	switch ((pint) GetAddress)
+	if (!speed)
+		speed = memory_speed(Address);
+
+	// RAM shared with a time-sliced SA-1 goes through its page handler.
+	if (Memory.Map[block] >= (uint8 *) CMemory::MAP_LAST)
+	{
+		OpenBus = S9xGetByte(Address);
+		return (OpenBus | (S9xGetByte(Address + 1) << 8));
+	}
+
+	switch ((pint) Memory.Map[block])
 	{
 		case CMemory::MAP_CPU:
 			word  = S9xGetCPU(Address & 0xffff);
@@ -423,6 +350,7 @@ inline uint16 S9xGetWord (uint32 Address, enum s9xwrap_t w = WRAP_NONE)
 			return (word);
 
 		case CMemory::MAP_BWRAM:
+			S9xSA1Sync();
 			word = READ_WORD(Memory.BWRAM + ((Address & 0x7fff) - 0x6000));
 			addCyclesInMemoryAccess_x2;
 			return (word);
@@ -493,108 +421,19 @@ inline uint16 S9xGetWord (uint32 Address, enum s9xwrap_t w = WRAP_NONE)
 
 inline void S9xSetByte (uint8 Byte, uint32 Address)
 {
-	int		block = (Address & 0xffffff) >> MEMMAP_SHIFT;
-	uint8	*SetAddress = Memory.WriteMap[block];
-	int32	speed = memory_speed(Address);
+	const struct SMemoryPage	*page = &Memory.Page[(Address & 0xffffff) >> MEMMAP_SHIFT];
+	int32	speed = page->Speed;
 
-	if (SetAddress >= (uint8 *) CMemory::MAP_LAST)
+	if (page->Write)
+		*(page->Write + (Address & 0xffff)) = Byte;
+	else
 	{
-		*(SetAddress + (Address & 0xffff)) = Byte;
-		addCyclesInMemoryAccess;
-		return;
+		if (!speed)
+			speed = memory_speed(Address);
+		page->Set(Byte, Address);
 	}
 
-	switch ((pint) SetAddress)
-	{
-		case CMemory::MAP_CPU:
-			S9xSetCPU(Byte, Address & 0xffff);
-			addCyclesInMemoryAccess;
-			return;
-
-		case CMemory::MAP_PPU:
-			if (CPU.InDMAorHDMA && (Address & 0xff00) == 0x2100)
-				return;
-
-			S9xSetPPU(Byte, Address & 0xffff);
-			addCyclesInMemoryAccess;
-			return;
-
-		case CMemory::MAP_LOROM_SRAM:
-			if (Memory.SRAMMask)
-			{
-				*(Memory.SRAM + ((((Address & 0xff0000) >> 1) | (Address & 0x7fff)) & Memory.SRAMMask)) = Byte;
-				CPU.SRAMModified = TRUE;
-			}
-
-			addCyclesInMemoryAccess;
-			return;
-
-		case CMemory::MAP_LOROM_SRAM_B:
-			if (Multi.sramMaskB)
-			{
-				*(Multi.sramB + ((((Address & 0xff0000) >> 1) | (Address & 0x7fff)) & Multi.sramMaskB)) = Byte;
-				CPU.SRAMModified = TRUE;
-			}
-
-			addCyclesInMemoryAccess;
-			return;
-
-		case CMemory::MAP_HIROM_SRAM:
-			if (Memory.SRAMMask)
-			{
-				*(Memory.SRAM + (((Address & 0x7fff) - 0x6000 + ((Address & 0xf0000) >> 3)) & Memory.SRAMMask)) = Byte;
-				CPU.SRAMModified = TRUE;
-			}
-
-			addCyclesInMemoryAccess;
-			return;
-
-		case CMemory::MAP_BWRAM:
-			*(Memory.BWRAM + ((Address & 0x7fff) - 0x6000)) = Byte;
-			CPU.SRAMModified = TRUE;
-			addCyclesInMemoryAccess;
-			return;
-
-		case CMemory::MAP_SA1RAM:
-			*(Memory.SRAM + (Address & 0xffff)) = Byte;
-			addCyclesInMemoryAccess;
-			return;
-
-		case CMemory::MAP_DSP:
-			S9xSetDSP(Byte, Address & 0xffff);
-			addCyclesInMemoryAccess;
-			return;
-
-		case CMemory::MAP_C4:
-			S9xSetC4(Byte, Address & 0xffff);
-			addCyclesInMemoryAccess;
-			return;
-
-		case CMemory::MAP_OBC_RAM:
-			S9xSetOBC1(Byte, Address & 0xffff);
-			addCyclesInMemoryAccess;
-			return;
-
-		case CMemory::MAP_SETA_DSP:
-			S9xSetSetaDSP(Byte, Address);
-			addCyclesInMemoryAccess;
-			return;
-
-		case CMemory::MAP_SETA_RISC:
-			S9xSetST018(Byte, Address);
-			addCyclesInMemoryAccess;
-			return;
-
-		case CMemory::MAP_BSX:
-			S9xSetBSX(Byte, Address);
-			addCyclesInMemoryAccess;
-			return;
-
-		case CMemory::MAP_NONE:
-		default:
-			addCyclesInMemoryAccess;
-			return;
-	}
+	addCyclesInMemoryAccess;
 }
 
 inline void S9xSetWord (uint16 Word, uint32 Address, enum s9xwrap_t w = WRAP_NONE, enum s9xwriteorder_t o = WRITE_01)
@@ -634,17 +473,36 @@ inline void S9xSetWord (uint16 Word, uint32 Address, enum s9xwrap_t w = WRAP_NON
 	}
 
 	int		block = (Address & 0xffffff) >> MEMMAP_SHIFT;
-	uint8	*SetAddress = Memory.WriteMap[block];
-	int32	speed = memory_speed(Address);
+	const struct SMemoryPage	*page = &Memory.Page[block];
+	int32	speed = page->Speed;
 
-	if (SetAddress >= (uint8 *) CMemory::MAP_LAST)
+	if (page->Write)
 	{
-		WRITE_WORD(SetAddress + (Address & 0xffff), Word);
+		WRITE_WORD(page->Write + (Address & 0xffff), Word);
 		addCyclesInMemoryAccess_x2;
 		return;
 	}
 
-	switch ((pint) SetAddress)
+	if (!speed)
+		speed = memory_speed(Address);
+
+	if (Memory.WriteMap[block] >= (uint8 *) CMemory::MAP_LAST)
+	{
+		if (o)
+		{
+			S9xSetByte(Word >> 8, Address + 1);
+			S9xSetByte((uint8) Word, Address);
+		}
+		else
+		{
+			S9xSetByte((uint8) Word, Address);
+			S9xSetByte(Word >> 8, Address + 1);
+		}
+
+		return;
+	}
+
+	switch ((pint) Memory.WriteMap[block])
 	{
 		case CMemory::MAP_CPU:
 			if (o)
@@ -743,6 +601,7 @@ inline void S9xSetWord (uint16 Word, uint32 Address, enum s9xwrap_t w = WRAP_NON
 			return;
 
 		case CMemory::MAP_BWRAM:
+			S9xSA1Sync();
 			WRITE_WORD(Memory.BWRAM + ((Address & 0x7fff) - 0x6000), Word);
 			CPU.SRAMModified = TRUE;
 			addCyclesInMemoryAccess_x2;
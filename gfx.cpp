@@ -176,6 +176,10 @@
  ***********************************************************************************/
 
 
+#ifdef USE_THREADS
+#include <pthread.h>
+#endif
+
 #include "snes9x.h"
 #include "ppu.h"
 #include "tile.h"
@@ -188,13 +192,12 @@
 #include "display.h"
 
 extern struct SCheatData		Cheat;
-extern struct SLineData			LineData[240];
-extern struct SLineMatrixData	LineMatrixData[240];
 
 void S9xComputeClipWindows (void);
 
 static int	font_width = 8, font_height = 9;
 
+static inline bool8 OBJDirty (void);
 static void SetupOBJ (void);
 static void DrawOBJS (int);
 static void DisplayFrameRate (void);
@@ -208,38 +211,62 @@ static void DrawBackgroundOffsetMosaic (int, uint8, uint8, int);
 static inline void DrawBackgroundMode7 (int, void (*DrawMath) (uint32, uint32, int), void (*DrawNomath) (uint32, uint32, int), int);
 static inline void DrawBackdrop (void);
 static inline void RenderScreen (bool8);
-static uint16 get_crosshair_color (uint8);
+static void RenderBand (bool8);
+static void RenderBands (bool8);
+static void RenderChangedLines (bool8);
+static void ForgetLines (int, int);
+#ifdef USE_THREADS
+static void StopRenderThreads (void);
+static void StartPipelinedFrame (void);
+static void EndPipelinedFrame (int &, int &);
+static void QueueLines (void);
+static void WaitPipelinedFrame (void);
+static void ResumeInlineDrawing (void);
+static void StopPipeline (void);
+#endif
+static pixel_t get_crosshair_color (uint8);
 
 #define TILE_PLUS(t, x)	(((t) & 0xfc00) | ((t + x) & 0x3ff))
 
 
 bool8 S9xGraphicsInit (void)
 {
-	S9xInitTileRenderer();
-	ZeroMemory(BlackColourMap, 256 * sizeof(uint16));
+	ZeroMemory(BlackColourMap, sizeof(BlackColourMap));
 
 #ifdef GFX_MULTI_FORMAT
 	if (GFX.BuildPixel == NULL)
 		S9xSetRenderPixelFormat(RGB565);
 #endif
 
+	S9xInitTileRenderer();
+	S9xRedrawAllLines();
+
 	GFX.DoInterlace = 0;
 	GFX.InterlaceFrame = 0;
-	GFX.RealPPL = GFX.Pitch >> 1;
+	GFX.RealPPL = GFX.Pitch / sizeof(pixel_t);
+	GFX.VRAM = Memory.VRAM;
+	GFX.FillRAM = Memory.FillRAM;
 	IPPU.OBJChanged = TRUE;
 	IPPU.DirectColourMapsNeedRebuild = TRUE;
 	Settings.BG_Forced = 0;
 	S9xFixColourBrightness();
 
-	GFX.X2   = (uint16 *) malloc(sizeof(uint16) * 0x10000);
-	GFX.ZERO = (uint16 *) malloc(sizeof(uint16) * 0x10000);
-
-	GFX.ScreenSize = GFX.Pitch / 2 * SNES_HEIGHT_EXTENDED * (Settings.SupportHiRes ? 2 : 1);
-	GFX.SubScreen  = (uint16 *) malloc(GFX.ScreenSize * sizeof(uint16));
+	GFX.ScreenSize = GFX.Pitch / sizeof(pixel_t) * SNES_HEIGHT_EXTENDED * (Settings.SupportHiRes ? 2 : 1);
+	GFX.SubScreen  = (pixel_t *) malloc(GFX.ScreenSize * sizeof(pixel_t));
 	GFX.ZBuffer    = (uint8 *)  malloc(GFX.ScreenSize);
 	GFX.SubZBuffer = (uint8 *)  malloc(GFX.ScreenSize);
 
-	if (!GFX.X2 || !GFX.ZERO || !GFX.SubScreen || !GFX.ZBuffer || !GFX.SubZBuffer)
+	if (!GFX.SubScreen || !GFX.ZBuffer || !GFX.SubZBuffer)
+	{
+		S9xGraphicsDeinit();
+		return (FALSE);
+	}
+
+#if PIXEL_BITS == 16
+	GFX.X2   = (uint16 *) malloc(sizeof(uint16) * 0x10000);
+	GFX.ZERO = (uint16 *) malloc(sizeof(uint16) * 0x10000);
+
+	if (!GFX.X2 || !GFX.ZERO)
 	{
 		S9xGraphicsDeinit();
 		return (FALSE);
@@ -302,32 +329,78 @@ bool8 S9xGraphicsInit (void)
 			}
 		}
 	}
+#endif
 
 	return (TRUE);
 }
 
 void S9xGraphicsDeinit (void)
 {
+#ifdef USE_THREADS
+	StopPipeline();
+	StopRenderThreads();
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (GFX.Pipeline.Screen[i]) { free(GFX.Pipeline.Screen[i]); GFX.Pipeline.Screen[i] = NULL; }
+	}
+
+	GFX.Pipeline.Active = GFX.Pipeline.Pending = FALSE;
+#endif
+
+#if PIXEL_BITS == 16
 	if (GFX.X2)         { free(GFX.X2);         GFX.X2         = NULL; }
 	if (GFX.ZERO)       { free(GFX.ZERO);       GFX.ZERO       = NULL; }
+#endif
 	if (GFX.SubScreen)  { free(GFX.SubScreen);  GFX.SubScreen  = NULL; }
 	if (GFX.ZBuffer)    { free(GFX.ZBuffer);    GFX.ZBuffer    = NULL; }
 	if (GFX.SubZBuffer) { free(GFX.SubZBuffer); GFX.SubZBuffer = NULL; }
 }
 
+// The palette builders are instantiated for every pixel format, and S9xSetRenderPixelFormat picks one.
+
+template <int FMT>
+static void BuildDirectColourMaps (void)
+{
+	for (uint32 p = 0; p < 8; p++)
+		for (uint32 c = 0; c < 256; c++)
+			DirectColourMaps[p][c] = PixelFormat<FMT>::Build(IPPU.XB[((c & 7) << 2) | ((p & 1) << 1)], IPPU.XB[((c & 0x38) >> 1) | (p & 2)], IPPU.XB[((c & 0xc0) >> 3) | (p & 4)]);
+}
+
+template <int FMT>
+static void BuildScreenColors (void)
+{
+	for (int i = 0; i < 256; i++)
+		IPPU.ScreenColors[i] = PixelFormat<FMT>::Build(IPPU.Red[i], IPPU.Green[i], IPPU.Blue[i]);
+}
+
 void S9xBuildDirectColourMaps (void)
 {
 	IPPU.XB = mul_brightness[PPU.Brightness];
 
-	for (uint32 p = 0; p < 8; p++)
-		for (uint32 c = 0; c < 256; c++)
-			DirectColourMaps[p][c] = BUILD_PIXEL(IPPU.XB[((c & 7) << 2) | ((p & 1) << 1)], IPPU.XB[((c & 0x38) >> 1) | (p & 2)], IPPU.XB[((c & 0xc0) >> 3) | (p & 4)]);
+#ifdef GFX_MULTI_FORMAT
+	(*GFX.BuildDirectColourMaps) ();
+#else
+	BuildDirectColourMaps<0> ();
+#endif
 
 	IPPU.DirectColourMapsNeedRebuild = FALSE;
 }
 
+void S9xBuildScreenColors (void)
+{
+#ifdef GFX_MULTI_FORMAT
+	(*GFX.BuildScreenColors) ();
+#else
+	BuildScreenColors<0> ();
+#endif
+}
+
 void S9xStartScreenRefresh (void)
 {
+	GFX.VRAM = Memory.VRAM;
+	GFX.FillRAM = Memory.FillRAM;
+
 	if (IPPU.RenderThisFrame)
 	{
 		GFX.InterlaceFrame = !GFX.InterlaceFrame;
@@ -350,7 +423,7 @@ void S9xStartScreenRefresh (void)
 
 			if (Settings.SupportHiRes && (PPU.BGMode == 5 || PPU.BGMode == 6 || IPPU.PseudoHires))
 			{
-				GFX.RealPPL = GFX.Pitch >> 1;
+				GFX.RealPPL = GFX.Pitch / sizeof(pixel_t);
 				IPPU.DoubleWidthPixels = TRUE;
 				IPPU.RenderedScreenWidth = SNES_WIDTH << 1;
 			}
@@ -361,7 +434,7 @@ void S9xStartScreenRefresh (void)
 					GFX.RealPPL = SNES_WIDTH;
 				else
 			#endif
-					GFX.RealPPL = GFX.Pitch >> 1;
+					GFX.RealPPL = GFX.Pitch / sizeof(pixel_t);
 				IPPU.DoubleWidthPixels = FALSE;
 				IPPU.RenderedScreenWidth = SNES_WIDTH;
 			}
@@ -385,10 +458,12 @@ void S9xStartScreenRefresh (void)
 
 		PPU.MosaicStart = 0;
 		PPU.RecomputeClipWindows = TRUE;
+		memset(GFX.DirtyLines, TRUE, sizeof(GFX.DirtyLines));
 		IPPU.PreviousLine = IPPU.CurrentLine = 0;
 
-		ZeroMemory(GFX.ZBuffer, GFX.ScreenSize);
-		ZeroMemory(GFX.SubZBuffer, GFX.ScreenSize);
+	#ifdef USE_THREADS
+		StartPipelinedFrame();
+	#endif
 	}
 
 	if (++IPPU.FrameCount % Memory.ROMFramesPerSecond == 0)
@@ -410,10 +485,18 @@ void S9xEndScreenRefresh (void)
 	{
 		FLUSH_REDRAW();
 
+		int	width  = IPPU.RenderedScreenWidth;
+		int	height = IPPU.RenderedScreenHeight;
+
+	#ifdef USE_THREADS
+		if (GFX.Pipeline.Active)
+			EndPipelinedFrame(width, height);
+	#endif
+
 		if (GFX.DoInterlace && GFX.InterlaceFrame == 0)
 		{
 			S9xControlEOF();
-			S9xContinueUpdate(IPPU.RenderedScreenWidth, IPPU.RenderedScreenHeight);
+			S9xContinueUpdate(width, height);
 		}
 		else
 		{
@@ -428,12 +511,12 @@ void S9xEndScreenRefresh (void)
 			S9xControlEOF();
 
 			if (Settings.TakeScreenshot)
-				S9xDoScreenshot(IPPU.RenderedScreenWidth, IPPU.RenderedScreenHeight);
+				S9xDoScreenshot(width, height);
 
 			if (Settings.AutoDisplayMessages)
-				S9xDisplayMessages(GFX.Screen, GFX.RealPPL, IPPU.RenderedScreenWidth, IPPU.RenderedScreenHeight, 1);
+				S9xDisplayMessages(GFX.Screen, GFX.RealPPL, width, height, 1);
 
-			S9xDeinitUpdate(IPPU.RenderedScreenWidth, IPPU.RenderedScreenHeight);
+			S9xDeinitUpdate(width, height);
 		}
 	}
 	else
@@ -511,7 +594,7 @@ void RenderLine (uint8 C)
 	{
 		// if we're not rendering this frame, we still need to update this
 		// XXX: Check ForceBlank? Or anything else?
-		if (IPPU.OBJChanged)
+		if (IPPU.OBJChanged || OBJDirty())
 			SetupOBJ();
 		PPU.RangeTimeOver |= GFX.OBJLines[C].RTOFlags;
 	}
@@ -529,7 +612,7 @@ static inline void RenderScreen (bool8 sub)
 			GFX.S += GFX.RealPPL;
 		GFX.DB = GFX.ZBuffer;
 		GFX.Clip = IPPU.Clip[0];
-		BGActive = Memory.FillRAM[0x212c] & ~Settings.BG_Forced;
+		BGActive = GFX.FillRAM[0x212c] & ~Settings.BG_Forced;
 		D = 32;
 	}
 	else
@@ -537,15 +620,15 @@ static inline void RenderScreen (bool8 sub)
 		GFX.S = GFX.SubScreen;
 		GFX.DB = GFX.SubZBuffer;
 		GFX.Clip = IPPU.Clip[1];
-		BGActive = Memory.FillRAM[0x212d] & ~Settings.BG_Forced;
-		D = (Memory.FillRAM[0x2130] & 2) << 4; // 'do math' depth flag
+		BGActive = GFX.FillRAM[0x212d] & ~Settings.BG_Forced;
+		D = (GFX.FillRAM[0x2130] & 2) << 4; // 'do math' depth flag
 	}
 
 	if (BGActive & 0x10)
 	{
 		BG.TileAddress = PPU.OBJNameBase;
 		BG.NameSelect = PPU.OBJNameSelect;
-		BG.EnableMath = !sub && (Memory.FillRAM[0x2131] & 0x10);
+		BG.EnableMath = !sub && (GFX.FillRAM[0x2131] & 0x10);
 		BG.StartPalette = 128;
 		S9xSelectTileConverter(4, FALSE, sub, FALSE);
 		S9xSelectTileRenderers(PPU.BGMode, sub, TRUE);
@@ -559,7 +642,7 @@ static inline void RenderScreen (bool8 sub)
 		if (BGActive & (1 << n)) \
 		{ \
 			BG.StartPalette = pal; \
-			BG.EnableMath = !sub && (Memory.FillRAM[0x2131] & (1 << n)); \
+			BG.EnableMath = !sub && (GFX.FillRAM[0x2131] & (1 << n)); \
 			BG.TileSizeH = (!hires && PPU.BG[n].BGSize) ? 16 : 8; \
 			BG.TileSizeV = (PPU.BG[n].BGSize) ? 16 : 8; \
 			S9xSelectTileConverter(depth, hires, sub, PPU.BGMosaic[n]); \
@@ -625,13 +708,13 @@ static inline void RenderScreen (bool8 sub)
 		case 7:
 			if (BGActive & 0x01)
 			{
-				BG.EnableMath = !sub && (Memory.FillRAM[0x2131] & 1);
+				BG.EnableMath = !sub && (GFX.FillRAM[0x2131] & 1);
 				DrawBackgroundMode7(0, GFX.DrawMode7BG1Math, GFX.DrawMode7BG1Nomath, D);
 			}
 
-			if ((Memory.FillRAM[0x2133] & 0x40) && (BGActive & 0x02))
+			if ((GFX.FillRAM[0x2133] & 0x40) && (BGActive & 0x02))
 			{
-				BG.EnableMath = !sub && (Memory.FillRAM[0x2131] & 2);
+				BG.EnableMath = !sub && (GFX.FillRAM[0x2131] & 2);
 				DrawBackgroundMode7(1, GFX.DrawMode7BG2Math, GFX.DrawMode7BG2Nomath, D);
 			}
 
@@ -640,14 +723,862 @@ static inline void RenderScreen (bool8 sub)
 
 	#undef DO_BG
 
-	BG.EnableMath = !sub && (Memory.FillRAM[0x2131] & 0x20);
+	BG.EnableMath = !sub && (GFX.FillRAM[0x2131] & 0x20);
 
 	DrawBackdrop();
 }
 
+#ifdef USE_THREADS
+// Render threads: S9xUpdateScreen draws lines [GFX.StartY, GFX.EndY], all with
+// the same PPU state, and every pixel only depends on its own line. So the
+// range is cut into horizontal bands, each drawn by one thread through its own
+// copy of GFX, BG, PPU, IPPU and the band's latched lines (see
+// GFX_THREAD_LOCAL), and the calling thread waits for all of them before the
+// CPU can change anything.
+// Converted tiles are shared: one thread claims a tile, the others wait for
+// it to publish the pixels (see ConvertSharedTile in tile.cpp).
+
+#define RENDER_THREADS_MAX	8
+#define RENDER_BAND_MIN		16	// fewer lines than this aren't worth a thread
+
+namespace render_pool
+{
+	struct Band
+	{
+		struct SGFX				gfx;
+		struct SBG				bg;
+		struct SPPU				*ppu;
+		struct InternalPPU		*ippu;
+		struct SLineData		*lines;
+		struct SLineMatrixData	*matrix;
+		bool8					active;
+		bool8					sub;
+	};
+
+	static Band				bands[RENDER_THREADS_MAX - 1];
+	static pthread_t		threads[RENDER_THREADS_MAX - 1];
+	static int				count   = 0;
+	static uint32			job     = 0;	// bumped for every dispatch
+	static int				pending = 0;
+	static bool8			quit    = FALSE;
+
+	static pthread_mutex_t	mutex = PTHREAD_MUTEX_INITIALIZER;
+	static pthread_cond_t	start = PTHREAD_COND_INITIALIZER;
+	static pthread_cond_t	done  = PTHREAD_COND_INITIALIZER;
+}
+
+static void * RenderThread (void *arg)
+{
+	using namespace render_pool;
+
+	Band	*band = (Band *) arg;
+	uint32	seen  = 0;
+
+	for (;;)
+	{
+		pthread_mutex_lock(&mutex);
+		while (seen == job && !quit)
+			pthread_cond_wait(&start, &mutex);
+		seen = job;
+		pthread_mutex_unlock(&mutex);
+
+		if (quit)
+			break;
+
+		if (band->active)
+		{
+			GFX  = band->gfx;
+			BG   = band->bg;
+			PPU  = *band->ppu;
+			IPPU = *band->ippu;
+
+			// Mosaic blocks read the line they start on, which can be in an
+			// earlier band, so take all the lines latched so far.
+			memcpy(LineData, band->lines, (GFX.EndY + 1) * sizeof(LineData[0]));
+			memcpy(LineMatrixData, band->matrix, (GFX.EndY + 1) * sizeof(LineMatrixData[0]));
+
+			RenderBand(band->sub);
+		}
+
+		pthread_mutex_lock(&mutex);
+		if (--pending == 0)
+			pthread_cond_signal(&done);
+		pthread_mutex_unlock(&mutex);
+	}
+
+	return (NULL);
+}
+
+static void StartRenderThreads (int n)
+{
+	using namespace render_pool;
+
+	if (n > RENDER_THREADS_MAX - 1)
+		n = RENDER_THREADS_MAX - 1;
+
+	quit = FALSE;
+
+	while (count < n && pthread_create(&threads[count], NULL, RenderThread, &bands[count]) == 0)
+		count++;
+}
+
+static void StopRenderThreads (void)
+{
+	using namespace render_pool;
+
+	if (!count)
+		return;
+
+	pthread_mutex_lock(&mutex);
+	quit = TRUE;
+	pthread_cond_broadcast(&start);
+	pthread_mutex_unlock(&mutex);
+
+	while (count)
+		pthread_join(threads[--count], NULL);
+}
+
+// Pipelined rendering: with Settings.PipelinedRendering, S9xUpdateScreen
+// doesn't draw at each flush but queues a copy of everything the renderer
+// reads there: PPU, IPPU, $2100-$21ff, the lines latched since the last flush
+// and, whenever it has been written to, VRAM. A render thread replays the
+// queue through S9xUpdateScreen into a screen of its own while the CPU goes on
+// with the next frame, and S9xEndScreenRefresh shows the frame before, which
+// has had a whole frame to finish.
+// The render thread has its own tile caches, invalidated by comparing each new
+// VRAM copy with the last one, and works out clip windows and direct colour
+// maps for itself. Interlaced frames are drawn over two refreshes into one
+// screen, so those are still drawn inline.
+
+#define PIPELINE_SEGMENTS	256		// flushes in flight
+#define PIPELINE_FRAMES		2
+#define PIPELINE_VRAM		4		// VRAM copies in flight
+#define PIPELINE_NO_VRAM	0xff
+
+namespace render_pipe
+{
+	enum
+	{
+		SEGMENT_FRAME,	// start drawing a frame
+		SEGMENT_LINES,	// draw the lines up to a flush
+		SEGMENT_END		// the frame is finished
+	};
+
+	struct Segment
+	{
+		uint8				type;
+		uint8				frame;
+		uint8				vram;			// VRAM copy to draw from from now on
+		uint8				regs[0x100];	// $2100-$21ff
+		struct SPPU			ppu;
+		struct InternalPPU	ippu;
+	};
+
+	struct Frame
+	{
+		struct SGFX				gfx;		// as at S9xStartScreenRefresh
+		struct SBG				bg;
+		struct SLineData		lines[240];
+		struct SLineMatrixData	matrix[240];
+		uint32					used;		// queue position after its last segment
+	};
+
+	static Segment			*segments = NULL;
+	static Frame			*frames   = NULL;
+	static int				frame     = 0;	// the one being queued
+	static uint8			*vram[PIPELINE_VRAM];
+	static uint32			vram_used[PIPELINE_VRAM];
+	static int				vram_next   = 0;
+	static uint8			*vram_source = NULL;	// the Memory.VRAM last copied
+
+	// The render thread's own
+	static uint8			*draw_vram = NULL;
+	static uint8			*draw_regs = NULL;
+	static uint8			*tile_cache[7];
+	static uint8			*tile_cached[7];
+
+	static uint32			queued   = 0;	// queue positions only ever go up
+	static uint32			finished = 0;
+	static bool8			running  = FALSE;
+	static bool8			quit     = FALSE;
+	static pthread_t		thread;
+
+	static pthread_mutex_t	mutex = PTHREAD_MUTEX_INITIALIZER;
+	static pthread_cond_t	ready = PTHREAD_COND_INITIALIZER;
+	static pthread_cond_t	done  = PTHREAD_COND_INITIALIZER;
+
+	static const uint32		tiles[7] = { MAX_2BIT_TILES, MAX_4BIT_TILES, MAX_8BIT_TILES, MAX_2BIT_TILES, MAX_2BIT_TILES, MAX_4BIT_TILES, MAX_4BIT_TILES };
+}
+
+static void WaitPipeline (uint32 position)
+{
+	using namespace render_pipe;
+
+	pthread_mutex_lock(&mutex);
+	while ((int32) (finished - position) < 0)
+		pthread_cond_wait(&done, &mutex);
+	pthread_mutex_unlock(&mutex);
+}
+
+static render_pipe::Segment & NewSegment (uint8 type)
+{
+	using namespace render_pipe;
+
+	WaitPipeline(queued + 1 - PIPELINE_SEGMENTS);
+
+	Segment	&s = segments[queued % PIPELINE_SEGMENTS];
+	s.type  = type;
+	s.frame = frame;
+	s.vram  = PIPELINE_NO_VRAM;
+
+	return (s);
+}
+
+static void PushSegment (void)
+{
+	using namespace render_pipe;
+
+	pthread_mutex_lock(&mutex);
+	frames[frame].used = ++queued;
+	pthread_cond_signal(&ready);
+	pthread_mutex_unlock(&mutex);
+}
+
+static void LoadVRAM (const uint8 *src)
+{
+	using namespace render_pipe;
+
+	// Forget the converted tiles over every 16 bytes that changed, the same
+	// ones the VRAM write handlers in ppu.h forget for each byte.
+	for (uint32 a = 0; a < 0x10000; a += 16)
+	{
+		if (!memcmp(draw_vram + a, src + a, 16))
+			continue;
+
+		tile_cached[TILE_2BIT][a >> 4] = FALSE;
+		tile_cached[TILE_4BIT][a >> 5] = FALSE;
+		tile_cached[TILE_8BIT][a >> 6] = FALSE;
+		tile_cached[TILE_2BIT_EVEN][a >> 4] = FALSE;
+		tile_cached[TILE_2BIT_EVEN][((a >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
+		tile_cached[TILE_2BIT_ODD] [a >> 4] = FALSE;
+		tile_cached[TILE_2BIT_ODD] [((a >> 4) - 1) & (MAX_2BIT_TILES - 1)] = FALSE;
+		tile_cached[TILE_4BIT_EVEN][a >> 5] = FALSE;
+		tile_cached[TILE_4BIT_EVEN][((a >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+		tile_cached[TILE_4BIT_ODD] [a >> 5] = FALSE;
+		tile_cached[TILE_4BIT_ODD] [((a >> 5) - 1) & (MAX_4BIT_TILES - 1)] = FALSE;
+	}
+
+	memcpy(draw_vram, src, 0x10000);
+}
+
+static void DrawSegment (render_pipe::Segment &s)
+{
+	using namespace render_pipe;
+
+	Frame	&f = frames[s.frame];
+
+	switch (s.type)
+	{
+		case SEGMENT_FRAME:
+			GFX = f.gfx;
+			BG  = f.bg;
+			GFX.VRAM = draw_vram;
+			GFX.FillRAM = draw_regs;
+			GFX.Pipeline.Active = FALSE;
+			GFX.Pipeline.Pending = FALSE;
+			IPPU.DirectColourMapsNeedRebuild = TRUE;
+			break;
+
+		case SEGMENT_LINES:
+		{
+			if (s.vram != PIPELINE_NO_VRAM)
+				LoadVRAM(vram[s.vram]);
+
+			memcpy(draw_regs + 0x2100, s.regs, sizeof(s.regs));
+
+			// Keep the state only this thread works out
+			struct ClipData	clip[2][6];
+			bool8			rebuild = IPPU.DirectColourMapsNeedRebuild;
+			bool8			changed = IPPU.VRAMChanged;	// for line reuse
+			memcpy(clip, IPPU.Clip, sizeof(clip));
+
+			PPU  = s.ppu;
+			IPPU = s.ippu;
+
+			memcpy(IPPU.Clip, clip, sizeof(clip));
+			IPPU.DirectColourMapsNeedRebuild |= rebuild;
+			IPPU.VRAMChanged = changed || s.vram != PIPELINE_NO_VRAM;
+			memcpy(IPPU.TileCache,  tile_cache,  sizeof(tile_cache));
+			memcpy(IPPU.TileCached, tile_cached, sizeof(tile_cached));
+
+			for (int y = IPPU.PreviousLine; y < IPPU.CurrentLine && y < 240; y++)
+			{
+				LineData[y]       = f.lines[y];
+				LineMatrixData[y] = f.matrix[y];
+			}
+
+			S9xUpdateScreen();
+			break;
+		}
+
+		case SEGMENT_END:
+			break;
+	}
+}
+
+static void * PipelineThread (void *)
+{
+	using namespace render_pipe;
+
+	for (;;)
+	{
+		pthread_mutex_lock(&mutex);
+		while (finished == queued && !quit)
+			pthread_cond_wait(&ready, &mutex);
+		bool8	idle = (finished == queued);
+		pthread_mutex_unlock(&mutex);
+
+		if (idle)
+			break;
+
+		DrawSegment(segments[finished % PIPELINE_SEGMENTS]);
+
+		pthread_mutex_lock(&mutex);
+		finished++;
+		pthread_cond_broadcast(&done);
+		pthread_mutex_unlock(&mutex);
+	}
+
+	return (NULL);
+}
+
+static void FreePipeline (void)
+{
+	using namespace render_pipe;
+
+	free(segments);  segments  = NULL;
+	free(frames);    frames    = NULL;
+	free(draw_vram); draw_vram = NULL;
+	free(draw_regs); draw_regs = NULL;
+
+	for (int i = 0; i < PIPELINE_VRAM; i++)
+	{
+		free(vram[i]);
+		vram[i] = NULL;
+	}
+
+	for (int t = 0; t < 7; t++)
+	{
+		free(tile_cache[t]);  tile_cache[t]  = NULL;
+		free(tile_cached[t]); tile_cached[t] = NULL;
+	}
+}
+
+static bool8 StartPipeline (void)
+{
+	using namespace render_pipe;
+
+	if (running)
+		return (TRUE);
+
+	bool8	ok = TRUE;
+
+	segments  = (Segment *) malloc(PIPELINE_SEGMENTS * sizeof(Segment));
+	frames    = (Frame *)   malloc(PIPELINE_FRAMES * sizeof(Frame));
+	draw_vram = (uint8 *)   calloc(0x10000, 1);
+	draw_regs = (uint8 *)   calloc(0x2200, 1);
+	ok = segments && frames && draw_vram && draw_regs;
+
+	for (int i = 0; i < PIPELINE_VRAM; i++)
+	{
+		vram[i] = (uint8 *) malloc(0x10000);
+		vram_used[i] = queued;
+		ok = ok && vram[i];
+	}
+
+	for (int t = 0; t < 7; t++)
+	{
+		tile_cache[t]  = (uint8 *) malloc(tiles[t] * 64);
+		tile_cached[t] = (uint8 *) calloc(tiles[t], 1);
+		ok = ok && tile_cache[t] && tile_cached[t];
+	}
+
+	if (ok)
+	{
+		for (int i = 0; i < PIPELINE_FRAMES; i++)
+			frames[i].used = queued;
+
+		vram_source = NULL;
+		quit = FALSE;
+		running = pthread_create(&thread, NULL, PipelineThread, NULL) == 0;
+	}
+
+	if (!running)
+		FreePipeline();
+
+	return (running);
+}
+
+static void StopPipeline (void)
+{
+	using namespace render_pipe;
+
+	if (!running)
+		return;
+
+	// The thread finishes what is queued before it goes
+	pthread_mutex_lock(&mutex);
+	quit = TRUE;
+	pthread_cond_signal(&ready);
+	pthread_mutex_unlock(&mutex);
+
+	pthread_join(thread, NULL);
+	running = FALSE;
+
+	FreePipeline();
+}
+
+static void StartPipelinedFrame (void)
+{
+	using namespace render_pipe;
+
+	// Line reuse and GFX.DirtyLines go by the screen the port is shown, which
+	// a pipelined frame is copied into whole
+	bool8	pipelined = Settings.PipelinedRendering && !Settings.ReuseUnchangedLines && !GFX.DoInterlace;
+
+#ifdef USE_OPENGL
+	// The frame may be shown at a different pitch than it was drawn at
+	if (Settings.OpenGLEnable)
+		pipelined = FALSE;
+#endif
+
+	for (int i = 0; pipelined && i < 2; i++)
+	{
+		if (!GFX.Pipeline.Screen[i])
+			GFX.Pipeline.Screen[i] = (pixel_t *) malloc(GFX.ScreenSize * sizeof(pixel_t));
+		pipelined = GFX.Pipeline.Screen[i] != NULL;
+	}
+
+	if (!pipelined || !StartPipeline())
+	{
+		// This frame is drawn inline, with buffers and render threads the
+		// render thread may still be using
+		if (running)
+			WaitPipeline(queued);
+
+		if (GFX.Pipeline.Pending)
+		{
+			GFX.Pipeline.Pending = FALSE;
+			ResumeInlineDrawing();
+		}
+
+		return;
+	}
+
+	frame = (frame + 1) % PIPELINE_FRAMES;
+	WaitPipeline(frames[frame].used);
+
+	frames[frame].gfx = GFX;
+	frames[frame].gfx.Screen = GFX.Pipeline.Screen[GFX.Pipeline.Current];
+	frames[frame].bg = BG;
+
+	NewSegment(SEGMENT_FRAME);
+	PushSegment();
+
+	GFX.Pipeline.Active = TRUE;
+}
+
+static void QueueLines (void)
+{
+	using namespace render_pipe;
+
+	Segment	&s = NewSegment(SEGMENT_LINES);
+	Frame	&f = frames[frame];
+
+	s.ppu  = PPU;
+	s.ippu = IPPU;
+	memcpy(s.regs, Memory.FillRAM + 0x2100, sizeof(s.regs));
+
+	if (IPPU.VRAMChanged || vram_source != Memory.VRAM)
+	{
+		int	v = vram_next;
+		vram_next = (v + 1) % PIPELINE_VRAM;
+
+		WaitPipeline(vram_used[v]);
+		memcpy(vram[v], Memory.VRAM, 0x10000);
+		vram_used[v] = queued + 1;
+		vram_source = Memory.VRAM;
+		IPPU.VRAMChanged = FALSE;
+		s.vram = v;
+	}
+
+	for (int y = IPPU.PreviousLine; y < IPPU.CurrentLine && y < 240; y++)
+	{
+		f.lines[y]  = LineData[y];
+		f.matrix[y] = LineMatrixData[y];
+	}
+
+	// The render thread rebuilds them when it next needs them
+	IPPU.DirectColourMapsNeedRebuild = FALSE;
+
+	PushSegment();
+}
+
+static void ShowPipelinedFrame (const pixel_t *src, int width, int height)
+{
+	const pixel_t	black = BUILD_PIXEL(0, 0, 0);
+
+	for (int y = 0; y < height; y++)
+	{
+		pixel_t	*dst = GFX.Screen + y * GFX.RealPPL;
+
+		if (src)
+			memcpy(dst, src + y * GFX.RealPPL, width * sizeof(pixel_t));
+		else
+			for (int x = 0; x < width; x++)
+				dst[x] = black;
+	}
+}
+
+static void EndPipelinedFrame (int &width, int &height)
+{
+	using namespace render_pipe;
+
+	int	current = GFX.Pipeline.Current;
+
+	NewSegment(SEGMENT_END);
+	PushSegment();
+
+	GFX.Pipeline.Active = FALSE;
+
+	if (GFX.DoInterlace)
+	{
+		// It went interlaced part way, and the other field is to be drawn
+		// inline over this one, so it has to be finished now
+		WaitPipeline(queued);
+		ShowPipelinedFrame(GFX.Pipeline.Screen[current], width, height);
+
+		GFX.Pipeline.Pending = FALSE;
+		ResumeInlineDrawing();
+		return;
+	}
+
+	int	w = width, h = height;
+
+	if (GFX.Pipeline.Pending)
+	{
+		width  = GFX.Pipeline.Width;
+		height = GFX.Pipeline.Height;
+
+		WaitPipeline(GFX.Pipeline.Done);
+		ShowPipelinedFrame(GFX.Pipeline.Screen[!current], width, height);
+	}
+	else
+		ShowPipelinedFrame(NULL, width, height); // nothing finished yet
+
+	GFX.Pipeline.Pending = TRUE;
+	GFX.Pipeline.Width   = w;
+	GFX.Pipeline.Height  = h;
+	GFX.Pipeline.Done    = queued;
+	GFX.Pipeline.Current = !current;
+}
+
+static void WaitPipelinedFrame (void)
+{
+	// Lines drawn inline after the frame was queued share the Z buffers, the
+	// sub screen and the direct colour maps with the render thread
+	WaitPipeline(GFX.Pipeline.Done);
+	ResumeInlineDrawing();
+}
+
+static void ResumeInlineDrawing (void)
+{
+	// QueueLines has taken the VRAM change flag that line reuse on this thread
+	// goes by, and drawing here may take it back from the pipeline
+	render_pipe::vram_source = NULL;
+	IPPU.VRAMChanged = TRUE;
+	IPPU.DirectColourMapsNeedRebuild = TRUE;
+}
+#endif
+
+// Unchanged line reuse: with Settings.ReuseUnchangedLines, each line drawn gets a
+// fingerprint of everything its pixels depend on. A line whose fingerprint matches
+// the one it had last frame is left as it is in GFX.Screen, and GFX.DirtyLines
+// tells the port which lines were drawn again.
+// VRAM, CGRAM and OAM are summed up by an epoch, advanced only when their contents
+// really change, so games that upload the same data every frame still reuse lines.
+// The state belongs to the thread that draws into the screen it describes.
+// Pipelined frames are drawn into two screens of the render thread's and then
+// copied whole into GFX.Screen, so while lines are reused frames are drawn inline.
+
+namespace line_reuse
+{
+	static GFX_THREAD_LOCAL uint64	fingerprint[SNES_HEIGHT_EXTENDED];
+	static GFX_THREAD_LOCAL bool8	valid[SNES_HEIGHT_EXTENDED];
+
+	static GFX_THREAD_LOCAL uint8	vram[0x10000];
+	static GFX_THREAD_LOCAL uint16	cgram[256];
+	static GFX_THREAD_LOCAL uint8	oam[512 + 32];
+	static GFX_THREAD_LOCAL uint32	epoch;
+
+	// FNV-1a parameters, put together from 32-bit halves for C++98
+	static const uint64	fnv_basis = ((uint64) 0xcbf29ce4 << 32) | 0x84222325;
+	static const uint64	fnv_prime = ((uint64) 0x00000100 << 32) | 0x000001b3;
+
+	static inline uint64 Hash (uint64 h, const void *data, size_t size)
+	{
+		// FNV-1a
+		const uint8	*p = (const uint8 *) data;
+
+		for (size_t i = 0; i < size; i++)
+			h = (h ^ p[i]) * fnv_prime;
+
+		return (h);
+	}
+
+	#define HASH(h, v)	Hash((h), &(v), sizeof(v))
+
+	static void UpdateEpoch (void)
+	{
+		bool8	changed = FALSE;
+
+		if (IPPU.VRAMChanged)
+		{
+			IPPU.VRAMChanged = FALSE;
+
+			if (memcmp(vram, GFX.VRAM, sizeof(vram)))
+			{
+				memcpy(vram, GFX.VRAM, sizeof(vram));
+				changed = TRUE;
+			}
+		}
+
+		if (memcmp(cgram, PPU.CGDATA, sizeof(cgram)))
+		{
+			memcpy(cgram, PPU.CGDATA, sizeof(cgram));
+			changed = TRUE;
+		}
+
+		if (memcmp(oam, PPU.OAMData, sizeof(oam)))
+		{
+			memcpy(oam, PPU.OAMData, sizeof(oam));
+			changed = TRUE;
+		}
+
+		if (changed)
+			epoch++;
+	}
+
+	// Everything the lines drawn now have in common
+	static uint64 BandFingerprint (bool8 sub)
+	{
+		uint64	h = fnv_basis;
+
+		h = HASH(h, epoch);
+		h = HASH(h, sub);
+		// The PPU registers that shape the picture, not the data ports and their addresses
+		h = Hash(h, GFX.FillRAM + 0x2100, 0x02);
+		h = Hash(h, GFX.FillRAM + 0x2105, 0x08);
+		h = Hash(h, GFX.FillRAM + 0x211a, 0x01);
+		h = Hash(h, GFX.FillRAM + 0x2123, 0x0f);
+		h = Hash(h, GFX.FillRAM + 0x2133, 0x01);
+		h = HASH(h, PPU.FixedColourRed);
+		h = HASH(h, PPU.FixedColourGreen);
+		h = HASH(h, PPU.FixedColourBlue);
+		h = HASH(h, PPU.FirstSprite);
+		h = HASH(h, PPU.OAMPriorityRotation);
+		h = HASH(h, GFX.Screen);
+		h = HASH(h, GFX.RealPPL);
+		h = HASH(h, GFX.PPL);
+		h = HASH(h, GFX.DoInterlace);
+		if (GFX.DoInterlace || IPPU.InterlaceOBJ)	// it flips every frame regardless
+			h = HASH(h, GFX.InterlaceFrame);
+		h = HASH(h, IPPU.DoubleWidthPixels);
+		h = HASH(h, IPPU.DoubleHeightPixels);
+		h = HASH(h, Settings.BG_Forced);
+		h = HASH(h, Settings.Transparency);
+		h = HASH(h, Settings.DisableGraphicWindows);
+	#ifdef GFX_MULTI_FORMAT
+		h = HASH(h, GFX.PixelFormat);
+	#endif
+
+		return (h);
+	}
+
+	#undef HASH
+}
+
+void S9xRedrawAllLines (void)
+{
+	ForgetLines(0, SNES_HEIGHT_EXTENDED - 1);
+}
+
+static void ForgetLines (int first, int last)
+{
+	using namespace line_reuse;
+
+	if (first < 0)
+		first = 0;
+	if (last > SNES_HEIGHT_EXTENDED - 1)
+		last = SNES_HEIGHT_EXTENDED - 1;
+
+	// Whatever is there now is not what the port was told it was
+	for (int y = first; y <= last; y++)
+	{
+		valid[y] = FALSE;
+		GFX.DirtyLines[y] = TRUE;
+	}
+}
+
+static void ForgetScreenRows (int first, int count)
+{
+	int	shift = IPPU.DoubleHeightPixels ? 1 : 0;
+
+	ForgetLines(first >> shift, (first + count - 1) >> shift);
+}
+
+static void RenderChangedLines (bool8 sub)
+{
+	using namespace line_reuse;
+
+	uint32	StartY = GFX.StartY, EndY = GFX.EndY;
+
+	// Vertical mosaic blocks take their offsets from lines above the band
+	if (!Settings.ReuseUnchangedLines || PPU.BGMosaic[0] || PPU.BGMosaic[1] || PPU.BGMosaic[2] || PPU.BGMosaic[3])
+	{
+		ForgetLines(StartY, EndY);
+		RenderBands(sub);
+		return;
+	}
+
+	UpdateEpoch();
+
+	uint64	band = BandFingerprint(sub);
+
+	for (uint32 y = StartY; y <= EndY; y++)
+	{
+		uint64	f = Hash(Hash(band, &LineData[y], sizeof(LineData[y])), &LineMatrixData[y], sizeof(LineMatrixData[y]));
+
+		GFX.DirtyLines[y] = !valid[y] || fingerprint[y] != f;
+		fingerprint[y] = f;
+		valid[y] = TRUE;
+	}
+
+	// Draw each run of changed lines as a band of its own
+	for (uint32 y = StartY; y <= EndY; y++)
+	{
+		if (!GFX.DirtyLines[y])
+			continue;
+
+		GFX.StartY = y;
+		while (y < EndY && GFX.DirtyLines[y + 1])
+			y++;
+		GFX.EndY = y;
+
+		RenderBands(sub);
+	}
+
+	GFX.StartY = StartY;
+	GFX.EndY   = EndY;
+}
+
+static void RenderBand (bool8 sub)
+{
+	// Clear the depth of just the lines about to be drawn, rather than both buffers every frame.
+	// The sub screen's is cleared even when it isn't drawn, since main screen math reads it.
+	uint32	width  = IPPU.DoubleWidthPixels ? SNES_WIDTH * 2 : SNES_WIDTH;
+	uint32	Offset = GFX.StartY * GFX.PPL;
+
+	for (uint32 l = GFX.StartY; l <= GFX.EndY; l++, Offset += GFX.PPL)
+	{
+		ZeroMemory(GFX.ZBuffer + Offset, width);
+		ZeroMemory(GFX.SubZBuffer + Offset, width);
+	}
+
+	if (sub)
+		RenderScreen(TRUE);
+	RenderScreen(FALSE);
+}
+
+static void RenderBands (bool8 sub)
+{
+#ifdef USE_THREADS
+	using namespace render_pool;
+
+	uint32	lines = GFX.EndY - GFX.StartY + 1;
+	int		n = Settings.RenderThreads;
+
+	if (n > (int) (lines / RENDER_BAND_MIN))
+		n = lines / RENDER_BAND_MIN;
+
+	if (n > 1 && count < n - 1)
+		StartRenderThreads(Settings.RenderThreads - 1);
+	if (n > count + 1)
+		n = count + 1;
+
+	if (n > 1)
+	{
+		uint32	StartY = GFX.StartY, EndY = GFX.EndY;
+		uint32	y = StartY + lines / n;
+
+		for (int i = 0; i < count; i++)
+		{
+			bands[i].active = i < n - 1;
+			if (!bands[i].active)
+				continue;
+
+			bands[i].gfx    = GFX;
+			bands[i].bg     = BG;
+			bands[i].ppu    = &PPU;
+			bands[i].ippu   = &IPPU;
+			bands[i].lines  = LineData;
+			bands[i].matrix = LineMatrixData;
+			bands[i].sub    = sub;
+			bands[i].gfx.StartY = y;
+			bands[i].gfx.EndY   = (i == n - 2) ? EndY : y + lines / n - 1;
+			y += lines / n;
+		}
+
+		pthread_mutex_lock(&mutex);
+		pending = count;
+		job++;
+		pthread_cond_broadcast(&start);
+		pthread_mutex_unlock(&mutex);
+
+		GFX.EndY = StartY + lines / n - 1;
+		RenderBand(sub);
+		GFX.EndY = EndY;
+
+		pthread_mutex_lock(&mutex);
+		while (pending)
+			pthread_cond_wait(&done, &mutex);
+		pthread_mutex_unlock(&mutex);
+
+		return;
+	}
+#endif
+
+	RenderBand(sub);
+}
+
 void S9xUpdateScreen (void)
 {
-	if (IPPU.OBJChanged || IPPU.InterlaceOBJ)
+	bool8	draw = TRUE;
+
+#ifdef USE_THREADS
+	if (GFX.Pipeline.Active)
+	{
+		// The render thread draws these lines from a copy of the state as it
+		// is now. Here we only follow the frame's size and the RTO flags.
+		QueueLines();
+		draw = FALSE;
+	}
+	else
+	if (GFX.Pipeline.Pending)
+		WaitPipelinedFrame();
+#endif
+
+	if (IPPU.OBJChanged || IPPU.InterlaceOBJ || OBJDirty())
 		SetupOBJ();
 
 	// XXX: Check ForceBlank? Or anything else?
@@ -664,7 +1595,8 @@ void S9xUpdateScreen (void)
 
 		if (PPU.RecomputeClipWindows)
 		{
-			S9xComputeClipWindows();
+			if (draw)
+				S9xComputeClipWindows();
 			PPU.RecomputeClipWindows = FALSE;
 		}
 
@@ -678,27 +1610,27 @@ void S9xUpdateScreen (void)
 					// Have to back out of the speed up hack where the low res.
 					// SNES image was rendered into a 256x239 sized buffer,
 					// ignoring the true, larger size of the buffer.
-					GFX.RealPPL = GFX.Pitch >> 1;
+					GFX.RealPPL = GFX.Pitch / sizeof(pixel_t);
 
-					for (register int32 y = (int32) GFX.StartY - 1; y >= 0; y--)
+					for (register int32 y = (int32) GFX.StartY - 1; draw && y >= 0; y--)
 					{
-						register uint16	*p = GFX.Screen + y * GFX.PPL     + 255;
-						register uint16	*q = GFX.Screen + y * GFX.RealPPL + 510;
+						register pixel_t	*p = GFX.Screen + y * GFX.PPL     + 255;
+						register pixel_t	*q = GFX.Screen + y * GFX.RealPPL + 510;
 
 						for (register int x = 255; x >= 0; x--, p--, q -= 2)
 							*q = *(q + 1) = *p;
 					}
 
-					GFX.PPL = GFX.RealPPL; // = GFX.Pitch >> 1 above
+					GFX.PPL = GFX.RealPPL; // = GFX.Pitch / sizeof(pixel_t) above
 				}
 				else
 			#endif
 				{
 					// Have to back out of the regular speed hack
-					for (register uint32 y = 0; y < GFX.StartY; y++)
+					for (register uint32 y = 0; draw && y < GFX.StartY; y++)
 					{
-						register uint16	*p = GFX.Screen + y * GFX.PPL + 255;
-						register uint16	*q = GFX.Screen + y * GFX.PPL + 510;
+						register pixel_t	*p = GFX.Screen + y * GFX.PPL + 255;
+						register pixel_t	*q = GFX.Screen + y * GFX.PPL + 510;
 
 						for (register int x = 255; x >= 0; x--, p--, q -= 2)
 							*q = *(q + 1) = *p;
@@ -716,25 +1648,24 @@ void S9xUpdateScreen (void)
 				GFX.PPL = GFX.RealPPL << 1;
 				GFX.DoInterlace = 2;
 
-				for (register int32 y = (int32) GFX.StartY - 1; y >= 0; y--)
-					memmove(GFX.Screen + y * GFX.PPL, GFX.Screen + y * GFX.RealPPL, IPPU.RenderedScreenWidth * sizeof(uint16));
+				for (register int32 y = (int32) GFX.StartY - 1; draw && y >= 0; y--)
+					memmove(GFX.Screen + y * GFX.PPL, GFX.Screen + y * GFX.RealPPL, IPPU.RenderedScreenWidth * sizeof(pixel_t));
 			}
 		}
 
-		if ((Memory.FillRAM[0x2130] & 0x30) != 0x30 && (Memory.FillRAM[0x2131] & 0x3f))
+		if ((GFX.FillRAM[0x2130] & 0x30) != 0x30 && (GFX.FillRAM[0x2131] & 0x3f))
 			GFX.FixedColour = BUILD_PIXEL(IPPU.XB[PPU.FixedColourRed], IPPU.XB[PPU.FixedColourGreen], IPPU.XB[PPU.FixedColourBlue]);
 
-		if (PPU.BGMode == 5 || PPU.BGMode == 6 || IPPU.PseudoHires ||
-			((Memory.FillRAM[0x2130] & 0x30) != 0x30 && (Memory.FillRAM[0x2130] & 2) && (Memory.FillRAM[0x2131] & 0x3f) && (Memory.FillRAM[0x212d] & 0x1f)))
-			// If hires (Mode 5/6 or pseudo-hires) or math is to be done
-			// involving the subscreen, then we need to render the subscreen...
-			RenderScreen(TRUE);
-
-		RenderScreen(FALSE);
+		// If hires (Mode 5/6 or pseudo-hires) or math is to be done
+		// involving the subscreen, then we need to render the subscreen...
+		if (draw)
+			RenderChangedLines(PPU.BGMode == 5 || PPU.BGMode == 6 || IPPU.PseudoHires ||
+				((GFX.FillRAM[0x2130] & 0x30) != 0x30 && (GFX.FillRAM[0x2130] & 2) && (GFX.FillRAM[0x2131] & 0x3f) && (GFX.FillRAM[0x212d] & 0x1f)));
 	}
 	else
+	if (draw)
 	{
-		const uint16	black = BUILD_PIXEL(0, 0, 0);
+		const pixel_t	black = BUILD_PIXEL(0, 0, 0);
 
 		GFX.S = GFX.Screen + GFX.StartY * GFX.PPL;
 		if (GFX.DoInterlace && GFX.InterlaceFrame)
@@ -745,9 +1676,148 @@ void S9xUpdateScreen (void)
 				GFX.S[x] = black;
 	}
 
+	if (PPU.ForcedBlanking || !draw)
+		ForgetLines(GFX.StartY, GFX.EndY);
+
 	IPPU.PreviousLine = IPPU.CurrentLine;
 }
 
+static inline bool8 OBJDirty (void)
+{
+	return ((IPPU.OBJDirty[0] | IPPU.OBJDirty[1] | IPPU.OBJDirty[2] | IPPU.OBJDirty[3]) != 0);
+}
+
+// Sets the width, visible tiles and vertical extent of one sprite the way the
+// normal case of SetupOBJ does.
+static inline void SizeOBJ (int S, int Width, int Height)
+{
+	GFX.OBJWidths[S] = Width;
+	GFX.OBJTop[S] = (uint8) (PPU.OBJ[S].VPos & 0xff);
+	GFX.OBJRows[S] = 0;
+
+	int	HPos = PPU.OBJ[S].HPos;
+	if (HPos == -256)
+		HPos = 0;
+
+	if (HPos > -Width && HPos <= 256)
+	{
+		if (HPos < 0)
+			GFX.OBJVisibleTiles[S] = (Width + HPos + 7) >> 3;
+		else
+		if (HPos + Width > 255)
+			GFX.OBJVisibleTiles[S] = (256 - HPos + 7) >> 3;
+		else
+			GFX.OBJVisibleTiles[S] = Width >> 3;
+
+		GFX.OBJRows[S] = Height;
+	}
+}
+
+static inline void MarkOBJLines (uint32 *Lines, int S)
+{
+	for (int i = 0; i < GFX.OBJRows[S]; i++)
+	{
+		uint8	Y = GFX.OBJTop[S] + i;
+		if (Y < SNES_HEIGHT_EXTENDED)
+			Lines[Y >> 5] |= 1 << (Y & 31);
+	}
+}
+
+// Rebuilds only the lines touched by the sprites in IPPU.OBJDirty, before and
+// after their change. Only valid in the normal priority case without
+// interlaced OBJ, and when the last SetupOBJ left OBJTop and OBJRows behind.
+// Returns FALSE if so many sprites or lines changed that a full rebuild is
+// cheaper.
+static bool8 UpdateOBJLines (int SmallWidth, int SmallHeight, int LargeWidth, int LargeHeight)
+{
+	uint32	Lines[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+	int		Sprites = 0;
+
+	for (int i = 0; i < 4; i++)
+		for (uint32 d = IPPU.OBJDirty[i]; d; d &= d - 1)
+			Sprites++;
+
+	if (Sprites > 16)
+		return (FALSE);
+
+	for (int S = 0; S < 128; S++)
+	{
+		if (!(IPPU.OBJDirty[S >> 5] & (1 << (S & 31))))
+			continue;
+
+		MarkOBJLines(Lines, S);
+		if (PPU.OBJ[S].Size)
+			SizeOBJ(S, LargeWidth, LargeHeight);
+		else
+			SizeOBJ(S, SmallWidth, SmallHeight);
+		MarkOBJLines(Lines, S);
+	}
+
+	int	Count = 0, First = SNES_HEIGHT_EXTENDED;
+	for (int Y = 0; Y < SNES_HEIGHT_EXTENDED; Y++)
+	{
+		if (Lines[Y >> 5] & (1 << (Y & 31)))
+		{
+			if (First > Y)
+				First = Y;
+			Count++;
+		}
+	}
+
+	if (Count > 64)
+		return (FALSE);
+
+	uint8	FirstSprite = PPU.FirstSprite;
+
+	for (int Y = First; Y < SNES_HEIGHT_EXTENDED; Y++)
+	{
+		if (!(Lines[Y >> 5] & (1 << (Y & 31))))
+			continue;
+
+		struct SGFX::OBJLine	*pLine = &GFX.OBJLines[Y];
+		uint8	Flags = 0;
+		int		j = 0;
+
+		pLine->Tiles = 34;
+
+		uint8	S = FirstSprite;
+		do
+		{
+			uint8	line = (uint8) (Y - GFX.OBJTop[S]);
+			if (line < GFX.OBJRows[S])
+			{
+				if (j >= 32)
+					Flags |= 0x40;
+				else
+				{
+					pLine->Tiles -= GFX.OBJVisibleTiles[S];
+					if (pLine->Tiles < 0)
+						Flags |= 0x80;
+
+					pLine->OBJ[j].Sprite = S;
+					if (PPU.OBJ[S].VFlip)
+						pLine->OBJ[j].Line = line ^ (GFX.OBJWidths[S] - 1);
+					else
+						pLine->OBJ[j].Line = line;
+					j++;
+				}
+			}
+
+			S = (S + 1) & 0x7f;
+		} while (S != FirstSprite);
+
+		for (; j < 32; j++)
+			pLine->OBJ[j].Sprite = -1;
+
+		pLine->LineRTOFlags = Flags;
+	}
+
+	for (int Y = First; Y < SNES_HEIGHT_EXTENDED; Y++)
+		GFX.OBJLines[Y].RTOFlags = GFX.OBJLines[Y].LineRTOFlags | (Y ? GFX.OBJLines[Y - 1].RTOFlags : 0);
+
+	return (TRUE);
+}
+
 static void SetupOBJ (void)
 {
 	int	SmallWidth, SmallHeight, LargeWidth, LargeHeight;
@@ -796,6 +1866,16 @@ static void SetupOBJ (void)
 			break;
 	}
 
+	// A change to a few OAM entries only needs their old and new lines redone
+	// as long as nothing that affects every sprite changed too.
+	if (!IPPU.OBJChanged && GFX.OBJIncremental && !IPPU.InterlaceOBJ &&
+		(!PPU.OAMPriorityRotation || !(PPU.OAMFlip & PPU.OAMAddr & 1)) &&
+		UpdateOBJLines(SmallWidth, SmallHeight, LargeWidth, LargeHeight))
+	{
+		ZeroMemory(IPPU.OBJDirty, sizeof(IPPU.OBJDirty));
+		return;
+	}
+
 	int	inc = IPPU.InterlaceOBJ ? 2 : 1;
 
 	int startline = (IPPU.InterlaceOBJ && GFX.InterlaceFrame) ? 1 : 0;
@@ -826,31 +1906,13 @@ static void SetupOBJ (void)
 		do
 		{
 			if (PPU.OBJ[S].Size)
-			{
-				GFX.OBJWidths[S] = LargeWidth;
-				Height = LargeHeight;
-			}
+				SizeOBJ(S, LargeWidth, Height = LargeHeight);
 			else
-			{
-				GFX.OBJWidths[S] = SmallWidth;
-				Height = SmallHeight;
-			}
-
-			int	HPos = PPU.OBJ[S].HPos;
-			if (HPos == -256)
-				HPos = 0;
+				SizeOBJ(S, SmallWidth, Height = SmallHeight);
 
-			if (HPos > -GFX.OBJWidths[S] && HPos <= 256)
+			if (GFX.OBJRows[S])
 			{
-				if (HPos < 0)
-					GFX.OBJVisibleTiles[S] = (GFX.OBJWidths[S] + HPos + 7) >> 3;
-				else
-				if (HPos + GFX.OBJWidths[S] > 255)
-					GFX.OBJVisibleTiles[S] = (256 - HPos + 7) >> 3;
-				else
-					GFX.OBJVisibleTiles[S] = GFX.OBJWidths[S] >> 3;
-
-				for (uint8 line = startline, Y = (uint8) (PPU.OBJ[S].VPos & 0xff); line < Height; Y++, line += inc)
+				for (uint8 line = startline, Y = GFX.OBJTop[S]; line < Height; Y++, line += inc)
 				{
 					if (Y >= SNES_HEIGHT_EXTENDED)
 						continue;
@@ -880,8 +1942,14 @@ static void SetupOBJ (void)
 			S = (S + 1) & 0x7f;
 		} while (S != FirstSprite);
 
+		GFX.OBJLines[0].LineRTOFlags = GFX.OBJLines[0].RTOFlags;
 		for (int Y = 1; Y < SNES_HEIGHT_EXTENDED; Y++)
+		{
+			GFX.OBJLines[Y].LineRTOFlags = GFX.OBJLines[Y].RTOFlags;
 			GFX.OBJLines[Y].RTOFlags |= GFX.OBJLines[Y - 1].RTOFlags;
+		}
+
+		GFX.OBJIncremental = !IPPU.InterlaceOBJ;
 	}
 	else // evil FirstSprite+Y case
 	{
@@ -965,8 +2033,11 @@ static void SetupOBJ (void)
 			if (j < 32)
 				GFX.OBJLines[Y].OBJ[j].Sprite = -1;
 		}
+
+		GFX.OBJIncremental = FALSE;
 	}
 
+	ZeroMemory(IPPU.OBJDirty, sizeof(IPPU.OBJDirty));
 	IPPU.OBJChanged = FALSE;
 }
 
@@ -1063,6 +2134,26 @@ static void DrawOBJS (int D)
 	}
 }
 
+// TRUE if Lines lines from Y are already at depth Z or above from Left to Right, so nothing a layer
+// draws at Z or below can show there. Layers go front to back, so this skips ones the layers above cover.
+
+static inline bool8 SpanOccluded (uint32 Y, uint32 Lines, uint32 Left, uint32 Right, int PixWidth, uint8 Z)
+{
+	uint8	*db = GFX.DB + Y * GFX.PPL + Left * PixWidth;
+	uint32	w = (Right - Left) * PixWidth;
+
+	for (uint32 l = 0; l < Lines; l++, db += GFX.PPL)
+	{
+		for (uint32 x = 0; x < w; x++)
+		{
+			if (db[x] < Z)
+				return (FALSE);
+		}
+	}
+
+	return (TRUE);
+}
+
 static void DrawBackground (int bg, uint8 Zh, uint8 Zl)
 {
 	BG.TileAddress = PPU.BG[bg].NameBase << 1;
@@ -1070,15 +2161,15 @@ static void DrawBackground (int bg, uint8 Zh, uint8 Zl)
 	uint32	Tile;
 	uint16	*SC0, *SC1, *SC2, *SC3;
 
-	SC0 = (uint16 *) &Memory.VRAM[PPU.BG[bg].SCBase << 1];
+	SC0 = (uint16 *) &GFX.VRAM[PPU.BG[bg].SCBase << 1];
 	SC1 = (PPU.BG[bg].SCSize & 1) ? SC0 + 1024 : SC0;
-	if (SC1 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC1 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC1 -= 0x8000;
 	SC2 = (PPU.BG[bg].SCSize & 2) ? SC1 + 1024 : SC0;
-	if (SC2 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC2 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC2 -= 0x8000;
 	SC3 = (PPU.BG[bg].SCSize & 1) ? SC2 + 1024 : SC2;
-	if (SC3 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC3 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC3 -= 0x8000;
 
 	uint32	Lines;
@@ -1121,6 +2212,9 @@ static void DrawBackground (int bg, uint8 Zh, uint8 Zl)
 			if (Y + Lines > GFX.EndY)
 				Lines = GFX.EndY - Y + 1;
 
+			if (SpanOccluded(Y, Lines, GFX.Clip[bg].Left[clip], GFX.Clip[bg].Right[clip], PixWidth, Zh))
+				continue;
+
 			VirtAlign <<= 3;
 
 			uint32	t1, t2;
@@ -1287,15 +2381,15 @@ static void DrawBackgroundMosaic (int bg, uint8 Zh, uint8 Zl)
 	uint32	Tile;
 	uint16	*SC0, *SC1, *SC2, *SC3;
 
-	SC0 = (uint16 *) &Memory.VRAM[PPU.BG[bg].SCBase << 1];
+	SC0 = (uint16 *) &GFX.VRAM[PPU.BG[bg].SCBase << 1];
 	SC1 = (PPU.BG[bg].SCSize & 1) ? SC0 + 1024 : SC0;
-	if (SC1 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC1 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC1 -= 0x8000;
 	SC2 = (PPU.BG[bg].SCSize & 2) ? SC1 + 1024 : SC0;
-	if (SC2 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC2 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC2 -= 0x8000;
 	SC3 = (PPU.BG[bg].SCSize & 1) ? SC2 + 1024 : SC2;
-	if (SC3 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC3 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC3 -= 0x8000;
 
 	int	Lines;
@@ -1306,10 +2400,10 @@ static void DrawBackgroundMosaic (int bg, uint8 Zh, uint8 Zl)
 
 	void (*DrawPix) (uint32, uint32, uint32, uint32, uint32, uint32);
 
-	int	MosaicStart = ((uint32) GFX.StartY - PPU.MosaicStart) % PPU.Mosaic;
-
 	for (int clip = 0; clip < GFX.Clip[bg].Count; clip++)
 	{
+		int	MosaicStart = ((uint32) GFX.StartY - PPU.MosaicStart) % PPU.Mosaic;
+
 		GFX.ClipColors = !(GFX.Clip[bg].DrawMode[clip] & 1);
 
 		if (BG.EnableMath && (GFX.Clip[bg].DrawMode[clip] & 2))
@@ -1454,26 +2548,26 @@ static void DrawBackgroundOffset (int bg, uint8 Zh, uint8 Zl, int VOffOff)
 	uint16	*SC0, *SC1, *SC2, *SC3;
 	uint16	*BPS0, *BPS1, *BPS2, *BPS3;
 
-	BPS0 = (uint16 *) &Memory.VRAM[PPU.BG[2].SCBase << 1];
+	BPS0 = (uint16 *) &GFX.VRAM[PPU.BG[2].SCBase << 1];
 	BPS1 = (PPU.BG[2].SCSize & 1) ? BPS0 + 1024 : BPS0;
-	if (BPS1 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (BPS1 >= (uint16 *) (GFX.VRAM + 0x10000))
 		BPS1 -= 0x8000;
 	BPS2 = (PPU.BG[2].SCSize & 2) ? BPS1 + 1024 : BPS0;
-	if (BPS2 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (BPS2 >= (uint16 *) (GFX.VRAM + 0x10000))
 		BPS2 -= 0x8000;
 	BPS3 = (PPU.BG[2].SCSize & 1) ? BPS2 + 1024 : BPS2;
-	if (BPS3 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (BPS3 >= (uint16 *) (GFX.VRAM + 0x10000))
 		BPS3 -= 0x8000;
 
-	SC0 = (uint16 *) &Memory.VRAM[PPU.BG[bg].SCBase << 1];
+	SC0 = (uint16 *) &GFX.VRAM[PPU.BG[bg].SCBase << 1];
 	SC1 = (PPU.BG[bg].SCSize & 1) ? SC0 + 1024 : SC0;
-	if (SC1 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC1 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC1 -= 0x8000;
 	SC2 = (PPU.BG[bg].SCSize & 2) ? SC1 + 1024 : SC0;
-	if (SC2 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC2 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC2 -= 0x8000;
 	SC3 = (PPU.BG[bg].SCSize & 1) ? SC2 + 1024 : SC2;
-	if (SC3 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC3 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC3 -= 0x8000;
 
 	int	OffsetMask   = (BG.TileSizeH   == 16) ? 0x3ff : 0x1ff;
@@ -1504,6 +2598,9 @@ static void DrawBackgroundOffset (int bg, uint8 Zh, uint8 Zl, int VOffOff)
 
 		for (uint32 Y = GFX.StartY; Y <= GFX.EndY; Y++)
 		{
+			if (SpanOccluded(Y, 1, GFX.Clip[bg].Left[clip], GFX.Clip[bg].Right[clip], PixWidth, Zh))
+				continue;
+
 			uint32	Y2 = HiresInterlace ? Y * 2 + GFX.InterlaceFrame : Y;
 			uint32	VOff = LineData[Y].BG[2].VOffset - 1;
 			uint32	HOff = LineData[Y].BG[2].HOffset;
@@ -1685,26 +2782,26 @@ static void DrawBackgroundOffsetMosaic (int bg, uint8 Zh, uint8 Zl, int VOffOff)
 	uint16	*SC0, *SC1, *SC2, *SC3;
 	uint16	*BPS0, *BPS1, *BPS2, *BPS3;
 
-	BPS0 = (uint16 *) &Memory.VRAM[PPU.BG[2].SCBase << 1];
+	BPS0 = (uint16 *) &GFX.VRAM[PPU.BG[2].SCBase << 1];
 	BPS1 = (PPU.BG[2].SCSize & 1) ? BPS0 + 1024 : BPS0;
-	if (BPS1 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (BPS1 >= (uint16 *) (GFX.VRAM + 0x10000))
 		BPS1 -= 0x8000;
 	BPS2 = (PPU.BG[2].SCSize & 2) ? BPS1 + 1024 : BPS0;
-	if (BPS2 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (BPS2 >= (uint16 *) (GFX.VRAM + 0x10000))
 		BPS2 -= 0x8000;
 	BPS3 = (PPU.BG[2].SCSize & 1) ? BPS2 + 1024 : BPS2;
-	if (BPS3 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (BPS3 >= (uint16 *) (GFX.VRAM + 0x10000))
 		BPS3 -= 0x8000;
 
-	SC0 = (uint16 *) &Memory.VRAM[PPU.BG[bg].SCBase << 1];
+	SC0 = (uint16 *) &GFX.VRAM[PPU.BG[bg].SCBase << 1];
 	SC1 = (PPU.BG[bg].SCSize & 1) ? SC0 + 1024 : SC0;
-	if (SC1 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC1 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC1 -= 0x8000;
 	SC2 = (PPU.BG[bg].SCSize & 2) ? SC1 + 1024 : SC0;
-	if (SC2 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC2 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC2 -= 0x8000;
 	SC3 = (PPU.BG[bg].SCSize & 1) ? SC2 + 1024 : SC2;
-	if (SC3 >= (uint16 *) (Memory.VRAM + 0x10000))
+	if (SC3 >= (uint16 *) (GFX.VRAM + 0x10000))
 		SC3 -= 0x8000;
 
 	int	Lines;
@@ -1718,10 +2815,10 @@ static void DrawBackgroundOffsetMosaic (int bg, uint8 Zh, uint8 Zl, int VOffOff)
 
 	void (*DrawPix) (uint32, uint32, uint32, uint32, uint32, uint32);
 
-	int	MosaicStart = ((uint32) GFX.StartY - PPU.MosaicStart) % PPU.Mosaic;
-
 	for (int clip = 0; clip < GFX.Clip[bg].Count; clip++)
 	{
+		int	MosaicStart = ((uint32) GFX.StartY - PPU.MosaicStart) % PPU.Mosaic;
+
 		GFX.ClipColors = !(GFX.Clip[bg].DrawMode[clip] & 1);
 
 		if (BG.EnableMath && (GFX.Clip[bg].DrawMode[clip] & 2))
@@ -1910,8 +3007,15 @@ static void DrawBackgroundOffsetMosaic (int bg, uint8 Zh, uint8 Zl, int VOffOff)
 
 static inline void DrawBackgroundMode7 (int bg, void (*DrawMath) (uint32, uint32, int), void (*DrawNomath) (uint32, uint32, int), int D)
 {
+	int		PixWidth = IPPU.DoubleWidthPixels ? 2 : 1;
+	uint32	Lines = (GFX.EndY >= GFX.StartY) ? GFX.EndY - GFX.StartY + 1 : 0;
+
 	for (int clip = 0; clip < GFX.Clip[bg].Count; clip++)
 	{
+		// BG1 draws at D + 7, BG2 at up to D + 11
+		if (SpanOccluded(GFX.StartY, Lines, GFX.Clip[bg].Left[clip], GFX.Clip[bg].Right[clip], PixWidth, D + (bg ? 11 : 7)))
+			continue;
+
 		GFX.ClipColors = !(GFX.Clip[bg].DrawMode[clip] & 1);
 
 		if (BG.EnableMath && (GFX.Clip[bg].DrawMode[clip] & 2))
@@ -1954,13 +3058,16 @@ void S9xSetInfoString (const char *string)
 	}
 }
 
-void S9xDisplayChar (uint16 *s, uint8 c)
+void S9xDisplayChar (pixel_t *s, uint8 c)
 {
-	const uint16	black = BUILD_PIXEL(0, 0, 0);
+	const pixel_t	black = BUILD_PIXEL(0, 0, 0);
 
 	int	line   = ((c - 32) >> 4) * font_height;
 	int	offset = ((c - 32) & 15) * font_width;
 
+	if (s >= GFX.Screen)
+		ForgetScreenRows((s - GFX.Screen) / GFX.RealPPL, font_height);
+
 	for (int h = 0; h < font_height; h++, line++, s += GFX.RealPPL - font_width)
 	{
 		for (int w = 0; w < font_width; w++, s++)
@@ -1981,7 +3088,7 @@ static void DisplayStringFromBottom (const char *string, int linesFromBottom, in
 	if (linesFromBottom <= 0)
 		linesFromBottom = 1;
 
-	uint16	*dst = GFX.Screen + (IPPU.RenderedScreenHeight - font_height * linesFromBottom) * GFX.RealPPL + pixelsFromLeft;
+	pixel_t	*dst = GFX.Screen + (IPPU.RenderedScreenHeight - font_height * linesFromBottom) * GFX.RealPPL + pixelsFromLeft;
 
 	int	len = strlen(string);
 	int	max_chars = IPPU.RenderedScreenWidth / (font_width - 1);
@@ -2182,7 +3289,7 @@ static void DisplayWatchedAddresses (void)
 	}
 }
 
-void S9xDisplayMessages (uint16 *screen, int ppl, int width, int height, int scale)
+void S9xDisplayMessages (pixel_t *screen, int ppl, int width, int height, int scale)
 {
 	if (Settings.DisplayFrameRate)
 		DisplayFrameRate();
@@ -2200,7 +3307,7 @@ void S9xDisplayMessages (uint16 *screen, int ppl, int width, int height, int sca
 		S9xDisplayString(GFX.InfoString, 5, 1, true);
 }
 
-static uint16 get_crosshair_color (uint8 color)
+static pixel_t get_crosshair_color (uint8 color)
 {
 	switch (color & 15)
 	{
@@ -2231,7 +3338,7 @@ void S9xDrawCrosshair (const char *crosshair, uint8 fgcolor, uint8 bgcolor, int1
 		return;
 
 	int16	r, rx = 1, c, cx = 1, W = SNES_WIDTH, H = PPU.ScreenHeight;
-	uint16	fg, bg;
+	pixel_t	fg, bg;
 
 	x -= 7;
 	y -= 7;
@@ -2242,7 +3349,9 @@ void S9xDrawCrosshair (const char *crosshair, uint8 fgcolor, uint8 bgcolor, int1
 	fg = get_crosshair_color(fgcolor);
 	bg = get_crosshair_color(bgcolor);
 
-	uint16	*s = GFX.Screen + y * (int32)GFX.RealPPL + x;
+	pixel_t	*s = GFX.Screen + y * (int32)GFX.RealPPL + x;
+
+	ForgetScreenRows(y, 15 * rx);
 
 	for (r = 0; r < 15 * rx; r++, s += GFX.RealPPL - 15 * cx)
 	{
@@ -2279,58 +3388,12 @@ void S9xDrawCrosshair (const char *crosshair, uint8 fgcolor, uint8 bgcolor, int1
 
 #ifdef GFX_MULTI_FORMAT
 
-static uint32 BuildPixelRGB565  (uint32, uint32, uint32);
-static uint32 BuildPixelRGB555  (uint32, uint32, uint32);
-static uint32 BuildPixelBGR565  (uint32, uint32, uint32);
-static uint32 BuildPixelBGR555  (uint32, uint32, uint32);
-static uint32 BuildPixelGBR565  (uint32, uint32, uint32);
-static uint32 BuildPixelGBR555  (uint32, uint32, uint32);
-static uint32 BuildPixelRGB5551 (uint32, uint32, uint32);
-
-static uint32 BuildPixel2RGB565  (uint32, uint32, uint32);
-static uint32 BuildPixel2RGB555  (uint32, uint32, uint32);
-static uint32 BuildPixel2BGR565  (uint32, uint32, uint32);
-static uint32 BuildPixel2BGR555  (uint32, uint32, uint32);
-static uint32 BuildPixel2GBR565  (uint32, uint32, uint32);
-static uint32 BuildPixel2GBR555  (uint32, uint32, uint32);
-static uint32 BuildPixel2RGB5551 (uint32, uint32, uint32);
-
-static void DecomposePixelRGB565  (uint32, uint32 &, uint32 &, uint32 &);
-static void DecomposePixelRGB555  (uint32, uint32 &, uint32 &, uint32 &);
-static void DecomposePixelBGR565  (uint32, uint32 &, uint32 &, uint32 &);
-static void DecomposePixelBGR555  (uint32, uint32 &, uint32 &, uint32 &);
-static void DecomposePixelGBR565  (uint32, uint32 &, uint32 &, uint32 &);
-static void DecomposePixelGBR555  (uint32, uint32 &, uint32 &, uint32 &);
-static void DecomposePixelRGB5551 (uint32, uint32 &, uint32 &, uint32 &);
-
-#define _BUILD_PIXEL(F) \
-static uint32 BuildPixel##F (uint32 R, uint32 G, uint32 B) \
-{ \
-	return (BUILD_PIXEL_##F(R, G, B)); \
-} \
-\
-static uint32 BuildPixel2##F (uint32 R, uint32 G, uint32 B) \
-{ \
-	return (BUILD_PIXEL2_##F(R, G, B)); \
-} \
-\
-static void DecomposePixel##F (uint32 pixel, uint32 &R, uint32 &G, uint32 &B) \
-{ \
-	DECOMPOSE_PIXEL_##F(pixel, R, G, B); \
-}
-
-_BUILD_PIXEL(RGB565)
-_BUILD_PIXEL(RGB555)
-_BUILD_PIXEL(BGR565)
-_BUILD_PIXEL(BGR555)
-_BUILD_PIXEL(GBR565)
-_BUILD_PIXEL(GBR555)
-_BUILD_PIXEL(RGB5551)
-
 #define _BUILD_SETUP(F) \
-GFX.BuildPixel             = BuildPixel##F; \
-GFX.BuildPixel2            = BuildPixel2##F; \
-GFX.DecomposePixel         = DecomposePixel##F; \
+GFX.BuildPixel             = PixelFormat<F>::Build; \
+GFX.BuildPixel2            = PixelFormat<F>::Build2; \
+GFX.DecomposePixel         = PixelFormat<F>::Decompose; \
+GFX.BuildScreenColors      = BuildScreenColors<F>; \
+GFX.BuildDirectColourMaps  = BuildDirectColourMaps<F>; \
 RED_LOW_BIT_MASK           = RED_LOW_BIT_MASK_##F; \
 GREEN_LOW_BIT_MASK         = GREEN_LOW_BIT_MASK_##F; \
 BLUE_LOW_BIT_MASK          = BLUE_LOW_BIT_MASK_##F; \
@@ -181,21 +181,25 @@
 
 struct SGFX
 {
-	uint16	*Screen;
-	uint16	*SubScreen;
+	pixel_t	*Screen;
+	pixel_t	*SubScreen;
 	uint8	*ZBuffer;
 	uint8	*SubZBuffer;
 	uint32	Pitch;
 	uint32	ScreenSize;
-	uint16	*S;
+	pixel_t	*S;
 	uint8	*DB;
+#if PIXEL_BITS == 16
 	uint16	*X2;
 	uint16	*ZERO;
+#endif
+	uint8	*VRAM;				// VRAM and PPU registers the renderer reads,
+	uint8	*FillRAM;			// Memory's own or a pipelined snapshot
 	uint32	RealPPL;			// true PPL of Screen buffer
 	uint32	PPL;				// number of pixels on each of Screen buffer
 	uint32	LinesPerTile;		// number of lines in 1 tile (4 or 8 due to interlace)
-	uint16	*ScreenColors;		// screen colors for rendering main
-	uint16	*RealScreenColors;	// screen colors, ignoring color window clipping
+	pixel_t	*ScreenColors;		// screen colors for rendering main
+	pixel_t	*RealScreenColors;	// screen colors, ignoring color window clipping
 	uint8	Z1;					// depth for comparison
 	uint8	Z2;					// depth to save
 	uint32	FixedColour;
@@ -203,15 +207,20 @@ struct SGFX
 	uint8	InterlaceFrame;
 	uint32	StartY;
 	uint32	EndY;
+	bool8	DirtyLines[SNES_HEIGHT_EXTENDED];	// FALSE for lines left as last frame drew them
 	bool8	ClipColors;
 	uint8	OBJWidths[128];
 	uint8	OBJVisibleTiles[128];
+	uint8	OBJTop[128];		// first line of each sprite
+	uint8	OBJRows[128];		// lines it covers from there, 0 if off screen
+	bool8	OBJIncremental;		// whether OBJTop and OBJRows let SetupOBJ redo just the lines of changed sprites
 
 	struct ClipData	*Clip;
 
-	struct
+	struct OBJLine
 	{
 		uint8	RTOFlags;
+		uint8	LineRTOFlags;	// RTOFlags without those of the lines above
 		int16	Tiles;
 
 		struct
@@ -226,6 +235,8 @@ struct SGFX
 	uint32	(*BuildPixel) (uint32, uint32, uint32);
 	uint32	(*BuildPixel2) (uint32, uint32, uint32);
 	void	(*DecomposePixel) (uint32, uint32 &, uint32 &, uint32 &);
+	void	(*BuildScreenColors) (void);
+	void	(*BuildDirectColourMaps) (void);
 #endif
 
 	void	(*DrawBackdropMath) (uint32, uint32, uint32);
@@ -244,6 +255,19 @@ struct SGFX
 	const char	*InfoString;
 	uint32	InfoStringTimeout;
 	char	FrameDisplayString[256];
+
+#ifdef USE_THREADS
+	struct
+	{
+		bool8	Active;			// this frame is being queued for the render thread
+		pixel_t	*Screen[2];		// frames drawn by the render thread
+		int		Current;		// which Screen this frame is drawn into
+		bool8	Pending;		// the other one holds a frame not yet shown
+		int		Width;			// size of the pending frame
+		int		Height;
+		uint32	Done;			// queue position at which it is finished
+	}	Pipeline;
+#endif
 };
 
 struct SBG
@@ -294,11 +318,21 @@ struct SLineMatrixData
 	short	M7VOFS;
 };
 
-extern uint16		BlackColourMap[256];
-extern uint16		DirectColourMaps[8][256];
+extern pixel_t		BlackColourMap[256];
+extern pixel_t		DirectColourMaps[8][256];
 extern uint8		mul_brightness[16][32];
-extern struct SBG	BG;
-extern struct SGFX	GFX;
+
+// Render threads draw through their own copies of these, and of PPU and IPPU
+#ifdef USE_THREADS
+#define GFX_THREAD_LOCAL	__thread
+#else
+#define GFX_THREAD_LOCAL
+#endif
+
+extern GFX_THREAD_LOCAL struct SBG				BG;
+extern GFX_THREAD_LOCAL struct SGFX				GFX;
+extern GFX_THREAD_LOCAL struct SLineData		LineData[240];
+extern GFX_THREAD_LOCAL struct SLineMatrixData	LineMatrixData[240];
 
 #define H_FLIP		0x4000
 #define V_FLIP		0x8000
@@ -309,6 +343,8 @@ extern struct SGFX	GFX;
 	((C2) & RGB_REMOVE_LOW_BITS_MASK)) >> 1) + \
 	((C1) & (C2) & RGB_LOW_BITS_MASK)) | ALPHA_BITS_MASK)
 
+#if PIXEL_BITS == 16
+
 #define COLOR_ADD(C1, C2) \
 	(GFX.X2[((((C1) & RGB_REMOVE_LOW_BITS_MASK) + \
 	((C2) & RGB_REMOVE_LOW_BITS_MASK)) >> 1) + \
@@ -319,9 +355,31 @@ extern struct SGFX	GFX;
 	GFX.ZERO[(((C1) | RGB_HI_BITS_MASKx2) - \
 	((C2) & RGB_REMOVE_LOW_BITS_MASK)) >> 1]
 
-inline uint16 COLOR_SUB (uint16 C1, uint16 C2)
+#else
+
+// 32-bit pixels are too big for the X2 and ZERO tables, so each colour byte saturates on its own:
+// doubling a halved sum whose top bit is set gives 0xff, and a halved difference without it gives 0.
+
+inline uint32 COLOR_ADD (uint32 C1, uint32 C2)
+{
+	uint32	h   = COLOR_ADD1_2(C1, C2);
+	uint32	top = h & RGB_HI_BITS_MASK;
+
+	return ((((h & ~RGB_HI_BITS_MASK) << 1) | ((top >> 7) * 0xff) | ((C1 ^ C2) & RGB_LOW_BITS_MASK)));
+}
+
+inline uint32 COLOR_SUB1_2 (uint32 C1, uint32 C2)
 {
-	uint16	mC1, mC2, v = ALPHA_BITS_MASK;
+	uint32	d = ((C1 | RGB_HI_BITS_MASKx2) - (C2 & RGB_REMOVE_LOW_BITS_MASK)) >> 1;
+
+	return (d & (((d & RGB_HI_BITS_MASK) >> 7) * 0x7f));
+}
+
+#endif
+
+inline pixel_t COLOR_SUB (pixel_t C1, pixel_t C2)
+{
+	pixel_t	mC1, mC2, v = ALPHA_BITS_MASK;
 
 	mC1 = C1 & FIRST_COLOR_MASK;
 	mC2 = C2 & FIRST_COLOR_MASK;
@@ -338,15 +396,67 @@ inline uint16 COLOR_SUB (uint16 C1, uint16 C2)
 	return (v);
 }
 
+// The colour math above with the masks of pixel format FMT as constants, for the renderers of tile.cpp
+
+template <int FMT>
+struct ColourMath
+{
+	typedef PixelFormat<FMT>	P;
+
+#if PIXEL_BITS == 16
+	static inline pixel_t Add1_2 (uint32 C1, uint32 C2)
+	{
+		return (((((C1 & P::RemoveLowBits) + (C2 & P::RemoveLowBits)) >> 1) + (C1 & C2 & P::LowBits)) | P::AlphaBits);
+	}
+
+	static inline pixel_t Add (uint32 C1, uint32 C2)
+	{
+		return (GFX.X2[(((C1 & P::RemoveLowBits) + (C2 & P::RemoveLowBits)) >> 1) + (C1 & C2 & P::LowBits)] | ((C1 ^ C2) & P::LowBits));
+	}
+
+	static inline pixel_t Sub1_2 (uint32 C1, uint32 C2)
+	{
+		return (GFX.ZERO[((C1 | P::HiBitsX2) - (C2 & P::RemoveLowBits)) >> 1]);
+	}
+#else
+	// only a compile-time PIXEL_FORMAT has 32 bits, so the macros are constant already
+	static inline pixel_t Add1_2 (uint32 C1, uint32 C2) { return (COLOR_ADD1_2(C1, C2)); }
+	static inline pixel_t Add (uint32 C1, uint32 C2)    { return (COLOR_ADD(C1, C2)); }
+	static inline pixel_t Sub1_2 (uint32 C1, uint32 C2) { return (COLOR_SUB1_2(C1, C2)); }
+#endif
+
+	static inline pixel_t Sub (pixel_t C1, pixel_t C2)
+	{
+		pixel_t	mC1, mC2, v = P::AlphaBits;
+
+		mC1 = C1 & P::FirstColor;
+		mC2 = C2 & P::FirstColor;
+		if (mC1 > mC2) v += (mC1 - mC2);
+
+		mC1 = C1 & P::SecondColor;
+		mC2 = C2 & P::SecondColor;
+		if (mC1 > mC2) v += (mC1 - mC2);
+
+		mC1 = C1 & P::ThirdColor;
+		mC2 = C2 & P::ThirdColor;
+		if (mC1 > mC2) v += (mC1 - mC2);
+
+		return (v);
+	}
+};
+
 void S9xStartScreenRefresh (void);
 void S9xEndScreenRefresh (void);
 void S9xUpdateScreen (void);
 void S9xBuildDirectColourMaps (void);
+void S9xBuildScreenColors (void);
 void RenderLine (uint8);
 void S9xComputeClipWindows (void);
-void S9xDisplayChar (uint16 *, uint8);
+void S9xDisplayChar (pixel_t *, uint8);
 // called automatically unless Settings.AutoDisplayMessages is false
-void S9xDisplayMessages (uint16 *, int, int, int, int);
+void S9xDisplayMessages (pixel_t *, int, int, int, int);
+// call after writing to GFX.Screen other than through the above, if Settings.ReuseUnchangedLines is set
+void S9xRedrawAllLines (void);
 #ifdef GFX_MULTI_FORMAT
 bool8 S9xSetRenderPixelFormat (int);
 #endif
@@ -194,15 +194,16 @@
 
 struct SCPUState		CPU;
 struct SICPU			ICPU;
+struct SIdleLoop		IdleLoop;
 struct SRegisters		Registers;
-struct SPPU				PPU;
-struct InternalPPU		IPPU;
+GFX_THREAD_LOCAL struct SPPU			PPU;
+GFX_THREAD_LOCAL struct InternalPPU		IPPU;
 struct SDMA				DMA[8];
 struct STimings			Timings;
-struct SGFX				GFX;
-struct SBG				BG;
-struct SLineData		LineData[240];
-struct SLineMatrixData	LineMatrixData[240];
+GFX_THREAD_LOCAL struct SGFX	GFX;
+GFX_THREAD_LOCAL struct SBG		BG;
+GFX_THREAD_LOCAL struct SLineData		LineData[240];
+GFX_THREAD_LOCAL struct SLineMatrixData	LineMatrixData[240];
 struct SDSP0			DSP0;
 struct SDSP1			DSP1;
 struct SDSP2			DSP2;
@@ -236,8 +237,8 @@ CMemory					Memory;
 char	String[513];
 uint8	OpenBus = 0;
 uint8	*HDMAMemPointers[8];
-uint16	BlackColourMap[256];
-uint16	DirectColourMaps[8][256];
+pixel_t	BlackColourMap[256];
+pixel_t	DirectColourMaps[8][256];
 
 SnesModel	M1SNES = { 1, 3, 2 };
 SnesModel	M2SNES = { 2, 4, 3 };
@@ -25,19 +25,14 @@ port_audio_samples_available_callback (void *data)
 void
 S9xPortAudioSoundDriver::mix (unsigned char *output, int bytes)
 {
-    g_mutex_lock (mutex);
-
     S9xMixSamples (output, bytes >> (Settings.SixteenBitSound ? 1 : 0));
 
-    g_mutex_unlock (mutex);
-
     return;
 }
 
 S9xPortAudioSoundDriver::S9xPortAudioSoundDriver(void)
 {
     audio_stream = NULL;
-    mutex = NULL;
 
     return;
 }
@@ -62,12 +57,6 @@ S9xPortAudioSoundDriver::terminate (void)
 {
     stop ();
 
-    if (mutex)
-    {
-        g_mutex_free (mutex);
-        mutex = NULL;
-    }
-
     S9xSetSamplesAvailableCallback (NULL, NULL);
 
     Pa_Terminate ();
@@ -195,7 +184,6 @@ S9xPortAudioSoundDriver::open_device (void)
         return FALSE;
     }
 
-    mutex = g_mutex_new ();
     S9xSetSamplesAvailableCallback (port_audio_samples_available_callback, this);
 
     fflush (stdout);
@@ -207,12 +195,8 @@ S9xPortAudioSoundDriver::open_device (void)
 void
 S9xPortAudioSoundDriver::samples_available (void)
 {
-    g_mutex_lock (mutex);
-
     S9xFinalizeSamples ();
 
-    g_mutex_unlock (mutex);
-
     return;
 }
 
@@ -22,7 +22,6 @@ class S9xPortAudioSoundDriver : public S9xSoundDriver
 
     private:
         PaStream *audio_stream;
-        GMutex *mutex;
 };
 
 
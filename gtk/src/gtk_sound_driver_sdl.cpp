@@ -12,9 +12,7 @@ sdl_audio_callback (void *userdata, Uint8 *stream, int len)
 static void
 samples_available (void *data)
 {
-    SDL_LockAudio ();
     S9xFinalizeSamples ();
-    SDL_UnlockAudio ();
 
     return;
 }
@@ -22,9 +20,7 @@ samples_available (void *data)
 void
 S9xSDLSoundDriver::mix (unsigned char *output, int bytes)
 {
-    SDL_LockAudio ();
     S9xMixSamples (output, bytes >> (Settings.SixteenBitSound ? 1 : 0));
-    SDL_UnlockAudio ();
 
     return;
 }
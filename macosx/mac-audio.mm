@@ -218,7 +218,6 @@ static EventHandlerUPP		carbonViewEventUPP = NULL;
 static EventHandlerRef		carbonViewEventRef = NULL;
 static WindowRef			effectWRef;
 static HISize				effectWSize;
-static pthread_mutex_t		mutex;
 static UInt32				outStoredFrames, cnvStoredFrames, revStoredFrames, eqlStoredFrames, devStoredFrames;
 
 static void ConnectAudioUnits (void);
@@ -309,7 +308,6 @@ void InitMacSound (void)
 	ConnectAudioUnits();
 	LoadEffectPresets();
 
-	pthread_mutex_init(&mutex, NULL);
 	S9xSetSamplesAvailableCallback(MacFinalizeSamplesCallBack, NULL); 
 }
 
@@ -317,7 +315,6 @@ void DeinitMacSound (void)
 {
 	OSStatus	err;
 
-	pthread_mutex_destroy(&mutex);
 	SaveEffectPresets();
 	DisconnectAudioUnits();
 	err = AUGraphUninitialize(agraph);
@@ -504,9 +501,7 @@ static OSStatus MacAURenderCallBack (void *inRefCon, AudioUnitRenderActionFlags
 		if (Settings.SixteenBitSound)
 			samples >>= 1;
 
-		pthread_mutex_lock(&mutex);
 		S9xMixSamples((uint8 *) ioData->mBuffers[0].mData, samples);
-		pthread_mutex_unlock(&mutex);
 	}
 	else	// Manually map L to R
 	{
@@ -516,9 +511,7 @@ static OSStatus MacAURenderCallBack (void *inRefCon, AudioUnitRenderActionFlags
 		if (Settings.SixteenBitSound)
 			monosmp >>= 1;
 
-		pthread_mutex_lock(&mutex);
 		S9xMixSamples((uint8 *) ioData->mBuffers[0].mData, monosmp);
-		pthread_mutex_unlock(&mutex);
 
 		if (Settings.SixteenBitSound)
 		{
@@ -537,9 +530,7 @@ static OSStatus MacAURenderCallBack (void *inRefCon, AudioUnitRenderActionFlags
 
 static void MacFinalizeSamplesCallBack (void *userData)
 { 
-	pthread_mutex_lock(&mutex);
 	S9xFinalizeSamples(); 
-	pthread_mutex_unlock(&mutex);
 }
 
 static void SaveEffectPresets (void)
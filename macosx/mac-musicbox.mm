@@ -581,7 +581,7 @@ static void SPCPlayExec (void)
 		CPU.Cycles = Timings.H_Max;
 		S9xAPUEndScanline();
 		CPU.Cycles = 0;
-		S9xAPUSetReferenceTime(0);
+		S9xAPUShiftReferenceTime(-Timings.H_Max);
 	}
 }
 
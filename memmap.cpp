@@ -191,6 +191,7 @@
 
 #include "snes9x.h"
 #include "memmap.h"
+#include "getset.h"
 #include "apu/apu.h"
 #include "fxemu.h"
 #include "sdd1.h"
@@ -945,6 +946,7 @@ static bool8 is_SameGame_Add_On (uint8 *, uint32);
 static bool8 is_GNEXT_BIOS (uint8 *, uint32);
 static bool8 is_GNEXT_Add_On (uint8 *, uint32);
 static uint32 caCRC32 (uint8 *, uint32, uint32 crc32 = 0xffffffff);
+static bool8 crc32_listed (const char *, uint32);
 static uint32 ReadUPSPointer (const uint8 *, unsigned &, unsigned);
 static bool8 ReadUPSPatch (Reader *, long, int32 &);
 static long ReadInt (Reader *, unsigned);
@@ -1065,6 +1067,7 @@ bool8 CMemory::Init (void)
     SRAM = (uint8 *) malloc(0x20000);
     VRAM = (uint8 *) malloc(0x10000);
     ROM  = (uint8 *) malloc(MAX_ROM_SIZE + 0x200 + 0x8000);
+	PageBuffer = (uint8 *) malloc(MEMMAP_NUM_BLOCKS * sizeof(struct SMemoryPage) + 63);
 
 	IPPU.TileCache[TILE_2BIT]       = (uint8 *) malloc(MAX_2BIT_TILES * 64);
 	IPPU.TileCache[TILE_4BIT]       = (uint8 *) malloc(MAX_4BIT_TILES * 64);
@@ -1082,7 +1085,7 @@ bool8 CMemory::Init (void)
 	IPPU.TileCached[TILE_4BIT_EVEN] = (uint8 *) malloc(MAX_4BIT_TILES);
 	IPPU.TileCached[TILE_4BIT_ODD]  = (uint8 *) malloc(MAX_4BIT_TILES);
 
-	if (!RAM || !SRAM || !VRAM || !ROM ||
+	if (!RAM || !SRAM || !VRAM || !ROM || !PageBuffer ||
 		!IPPU.TileCache[TILE_2BIT]       ||
 		!IPPU.TileCache[TILE_4BIT]       ||
 		!IPPU.TileCache[TILE_8BIT]       ||
@@ -1144,6 +1147,11 @@ bool8 CMemory::Init (void)
 	SuperFX.nRomBanks   = (2 * 1024 * 1024) / (32 * 1024);
 	SuperFX.pvRom       = (uint8 *) ROM;
 
+	// Keep the page table on cache line boundaries, and open bus until a ROM is mapped.
+	Page = (struct SMemoryPage *) (((pint) PageBuffer + 63) & ~(pint) 63);
+	Map_Initialize();
+	map_WriteProtectROM();
+
 	PostRomInitFunc = NULL;
 
 	return (TRUE);
@@ -1176,6 +1184,13 @@ void CMemory::Deinit (void)
 		ROM = NULL;
 	}
 
+	if (PageBuffer)
+	{
+		free(PageBuffer);
+		PageBuffer = NULL;
+		Page = NULL;
+	}
+
 	for (int t = 0; t < 7; t++)
 	{
 		if (IPPU.TileCache[t])
@@ -2670,6 +2685,8 @@ void CMemory::InitROM (void)
 
 	IPPU.TotalEmulatedFrames = 0;
 
+	S9xSelectMainLoop();
+
 	//// Hack games
 
 	ApplyROMFixes();
@@ -2940,6 +2957,311 @@ void CMemory::map_WriteProtectROM (void)
 		if (BlockIsROM[c])
 			WriteMap[c] = (uint8 *) MAP_NONE;
 	}
+
+	// Every mapper, including the BS-X remapping, finishes here.
+	map_Pages();
+}
+
+// Handlers for the blocks that are not plain memory, one per MAP_* type.
+// They mirror the cases S9xGetByte and S9xSetByte used to switch over.
+
+static uint8 GetPageCPU (uint32 Address)
+{
+	return (S9xGetCPU(Address & 0xffff));
+}
+
+static uint8 GetPagePPU (uint32 Address)
+{
+	if (CPU.InDMAorHDMA && (Address & 0xff00) == 0x2100)
+		return (OpenBus);
+
+	return (S9xGetPPU(Address & 0xffff));
+}
+
+static uint8 GetPageLoROMSRAM (uint32 Address)
+{
+	// Address & 0x7fff   : offset into bank
+	// Address & 0xff0000 : bank
+	// bank >> 1 | offset : SRAM address, unbound
+	// unbound & SRAMMask : SRAM offset
+	return (*(Memory.SRAM + ((((Address & 0xff0000) >> 1) | (Address & 0x7fff)) & Memory.SRAMMask)));
+}
+
+static uint8 GetPageLoROMSRAMB (uint32 Address)
+{
+	return (*(Multi.sramB + ((((Address & 0xff0000) >> 1) | (Address & 0x7fff)) & Multi.sramMaskB)));
+}
+
+static uint8 GetPageHiROMSRAM (uint32 Address)
+{
+	return (*(Memory.SRAM + (((Address & 0x7fff) - 0x6000 + ((Address & 0xf0000) >> 3)) & Memory.SRAMMask)));
+}
+
+static uint8 GetPageBWRAM (uint32 Address)
+{
+	return (*(Memory.BWRAM + ((Address & 0x7fff) - 0x6000)));
+}
+
+static uint8 GetPageDSP (uint32 Address)
+{
+	return (S9xGetDSP(Address & 0xffff));
+}
+
+static uint8 GetPageSPC7110ROM (uint32 Address)
+{
+	return (S9xGetSPC7110Byte(Address));
+}
+
+static uint8 GetPageSPC7110DRAM (uint32)
+{
+	return (S9xGetSPC7110(0x4800));
+}
+
+static uint8 GetPageC4 (uint32 Address)
+{
+	return (S9xGetC4(Address & 0xffff));
+}
+
+static uint8 GetPageOBC1 (uint32 Address)
+{
+	return (S9xGetOBC1(Address & 0xffff));
+}
+
+static uint8 GetPageSetaDSP (uint32 Address)
+{
+	return (S9xGetSetaDSP(Address));
+}
+
+static uint8 GetPageSetaRISC (uint32 Address)
+{
+	return (S9xGetST018(Address));
+}
+
+static uint8 GetPageBSX (uint32 Address)
+{
+	return (S9xGetBSX(Address));
+}
+
+static uint8 GetPageNone (uint32)
+{
+	return (OpenBus);
+}
+
+static void SetPageCPU (uint8 Byte, uint32 Address)
+{
+	S9xSetCPU(Byte, Address & 0xffff);
+}
+
+static void SetPagePPU (uint8 Byte, uint32 Address)
+{
+	if (CPU.InDMAorHDMA && (Address & 0xff00) == 0x2100)
+		return;
+
+	S9xSetPPU(Byte, Address & 0xffff);
+}
+
+static void SetPageLoROMSRAM (uint8 Byte, uint32 Address)
+{
+	if (Memory.SRAMMask)
+	{
+		*(Memory.SRAM + ((((Address & 0xff0000) >> 1) | (Address & 0x7fff)) & Memory.SRAMMask)) = Byte;
+		CPU.SRAMModified = TRUE;
+	}
+}
+
+static void SetPageLoROMSRAMB (uint8 Byte, uint32 Address)
+{
+	if (Multi.sramMaskB)
+	{
+		*(Multi.sramB + ((((Address & 0xff0000) >> 1) | (Address & 0x7fff)) & Multi.sramMaskB)) = Byte;
+		CPU.SRAMModified = TRUE;
+	}
+}
+
+static void SetPageHiROMSRAM (uint8 Byte, uint32 Address)
+{
+	if (Memory.SRAMMask)
+	{
+		*(Memory.SRAM + (((Address & 0x7fff) - 0x6000 + ((Address & 0xf0000) >> 3)) & Memory.SRAMMask)) = Byte;
+		CPU.SRAMModified = TRUE;
+	}
+}
+
+static void SetPageBWRAM (uint8 Byte, uint32 Address)
+{
+	*(Memory.BWRAM + ((Address & 0x7fff) - 0x6000)) = Byte;
+	CPU.SRAMModified = TRUE;
+}
+
+static void SetPageSA1RAM (uint8 Byte, uint32 Address)
+{
+	*(Memory.SRAM + (Address & 0xffff)) = Byte;
+}
+
+static void SetPageDSP (uint8 Byte, uint32 Address)
+{
+	S9xSetDSP(Byte, Address & 0xffff);
+}
+
+static void SetPageC4 (uint8 Byte, uint32 Address)
+{
+	S9xSetC4(Byte, Address & 0xffff);
+}
+
+static void SetPageOBC1 (uint8 Byte, uint32 Address)
+{
+	S9xSetOBC1(Byte, Address & 0xffff);
+}
+
+static void SetPageSetaDSP (uint8 Byte, uint32 Address)
+{
+	S9xSetSetaDSP(Byte, Address);
+}
+
+static void SetPageSetaRISC (uint8 Byte, uint32 Address)
+{
+	S9xSetST018(Byte, Address);
+}
+
+static void SetPageBSX (uint8 Byte, uint32 Address)
+{
+	S9xSetBSX(Byte, Address);
+}
+
+static void SetPageNone (uint8, uint32)
+{
+	return;
+}
+
+// With Settings.SA1TimeSlice, I-RAM and BW-RAM are kept off the direct paths
+// so that the SA-1 is brought up to date before every S-CPU access.
+
+static bool8 IsSA1Shared (uint8 *block)
+{
+	return (block == Memory.FillRAM || block == Memory.SRAM || block == Memory.SRAM + 0x10000 ||
+		block == (uint8 *) CMemory::MAP_BWRAM);
+}
+
+static uint8 GetPageSA1Shared (uint32 Address)
+{
+	uint8	*block = Memory.Map[(Address & 0xffffff) >> MEMMAP_SHIFT];
+
+	S9xSA1Sync();
+
+	if (block == (uint8 *) CMemory::MAP_BWRAM)
+		return (GetPageBWRAM(Address));
+
+	return (*(block + (Address & 0xffff)));
+}
+
+static void SetPageSA1Shared (uint8 Byte, uint32 Address)
+{
+	uint8	*block = Memory.WriteMap[(Address & 0xffffff) >> MEMMAP_SHIFT];
+
+	S9xSA1Sync();
+
+	if (block == (uint8 *) CMemory::MAP_BWRAM)
+		SetPageBWRAM(Byte, Address);
+	else
+		*(block + (Address & 0xffff)) = Byte;
+}
+
+void CMemory::map_Pages (void)
+{
+	for (int c = 0; c < MEMMAP_NUM_BLOCKS; c++)
+		map_Page(c);
+
+	map_PageSpeeds();
+}
+
+// Rebuilds the Page entry of one block from Map and WriteMap.
+void CMemory::map_Page (int c)
+{
+	struct SMemoryPage	*p = &Page[c];
+
+	p->Read = NULL;
+	p->Get = GetPageNone;
+
+	if (Map[c] >= (uint8 *) MAP_LAST)
+		p->Read = Map[c];
+	else
+	switch ((pint) Map[c])
+	{
+		case MAP_CPU:			p->Get = GetPageCPU;			break;
+		case MAP_PPU:			p->Get = GetPagePPU;			break;
+		case MAP_LOROM_SRAM:
+		case MAP_SA1RAM:		p->Get = GetPageLoROMSRAM;		break;
+		case MAP_LOROM_SRAM_B:	p->Get = GetPageLoROMSRAMB;		break;
+		case MAP_HIROM_SRAM:
+		case MAP_RONLY_SRAM:	p->Get = GetPageHiROMSRAM;		break;
+		case MAP_BWRAM:			p->Get = GetPageBWRAM;			break;
+		case MAP_DSP:			p->Get = GetPageDSP;			break;
+		case MAP_SPC7110_ROM:	p->Get = GetPageSPC7110ROM;		break;
+		case MAP_SPC7110_DRAM:	p->Get = GetPageSPC7110DRAM;	break;
+		case MAP_C4:			p->Get = GetPageC4;				break;
+		case MAP_OBC_RAM:		p->Get = GetPageOBC1;			break;
+		case MAP_SETA_DSP:		p->Get = GetPageSetaDSP;		break;
+		case MAP_SETA_RISC:		p->Get = GetPageSetaRISC;		break;
+		case MAP_BSX:			p->Get = GetPageBSX;			break;
+	}
+
+	p->Write = NULL;
+	p->Set = SetPageNone;
+
+	if (WriteMap[c] >= (uint8 *) MAP_LAST)
+		p->Write = WriteMap[c];
+	else
+	switch ((pint) WriteMap[c])
+	{
+		case MAP_CPU:			p->Set = SetPageCPU;			break;
+		case MAP_PPU:			p->Set = SetPagePPU;			break;
+		case MAP_LOROM_SRAM:	p->Set = SetPageLoROMSRAM;		break;
+		case MAP_LOROM_SRAM_B:	p->Set = SetPageLoROMSRAMB;		break;
+		case MAP_HIROM_SRAM:	p->Set = SetPageHiROMSRAM;		break;
+		case MAP_BWRAM:			p->Set = SetPageBWRAM;			break;
+		case MAP_SA1RAM:		p->Set = SetPageSA1RAM;			break;
+		case MAP_DSP:			p->Set = SetPageDSP;			break;
+		case MAP_C4:			p->Set = SetPageC4;				break;
+		case MAP_OBC_RAM:		p->Set = SetPageOBC1;			break;
+		case MAP_SETA_DSP:		p->Set = SetPageSetaDSP;		break;
+		case MAP_SETA_RISC:		p->Set = SetPageSetaRISC;		break;
+		case MAP_BSX:			p->Set = SetPageBSX;			break;
+	}
+
+	if (Settings.SA1 && Settings.SA1TimeSlice && IsSA1Shared(Map[c]))
+	{
+		p->Read = p->Write = NULL;
+		p->Get = GetPageSA1Shared;
+		p->Set = SetPageSA1Shared;
+	}
+}
+
+// Points one block elsewhere after the mappers have run, as the SA-1, S-DD1
+// and SPC7110 registers do, and keeps its Page entry in step with Map.
+void CMemory::map_Remap (int c, uint8 *block)
+{
+	Map[c] = block;
+	map_Page(c);
+}
+
+// Precomputes memory_speed() per block for the current FastROM setting, so
+// it has to run again whenever CPU.FastROMSpeed changes.
+void CMemory::map_PageSpeeds (void)
+{
+	for (int c = 0; c < MEMMAP_NUM_BLOCKS; c++)
+	{
+		uint32	address = c << MEMMAP_SHIFT;
+		int32	speed = memory_speed(address);
+
+		// $4000-$41ff is slower than the rest of its block.
+		for (uint32 a = address + 0x200; a < address + MEMMAP_BLOCK_SIZE; a += 0x200)
+		{
+			if (memory_speed(a) != speed)
+				speed = 0;
+		}
+
+		Page[c].Speed = speed;
+	}
 }
 
 void CMemory::Map_Initialize (void)
@@ -3593,10 +3915,42 @@ bool8 CMemory::match_id (const char *str)
 	return (strncmp(ROMId, str, strlen(str)) == 0);
 }
 
+static bool8 crc32_listed (const char *list, uint32 crc32)
+{
+	// list holds CRC32s in hex, separated by spaces or commas
+	while (*list)
+	{
+		char	*end;
+		uint32	n = strtoul(list, &end, 16);
+
+		if (end == list)
+			list++;
+		else
+		{
+			if (n == crc32)
+				return (TRUE);
+			list = end;
+		}
+	}
+
+	return (FALSE);
+}
+
 void CMemory::ApplyROMFixes (void)
 {
 	Settings.BlockInvalidVRAMAccess = Settings.BlockInvalidVRAMAccessMaster;
 
+	Settings.SkipIdleLoops = Settings.SkipIdleLoopsMaster;
+	if (crc32_listed(Settings.SkipIdleLoopsOn, ROMCRC32))
+		Settings.SkipIdleLoops = TRUE;
+	if (crc32_listed(Settings.SkipIdleLoopsOff, ROMCRC32))
+		Settings.SkipIdleLoops = FALSE;
+
+	// The SA-1 runs between the S-CPU's instructions, so nothing the S-CPU
+	// polls is guaranteed to hold still until the next event.
+	if (Settings.SA1)
+		Settings.SkipIdleLoops = FALSE;
+
 	//// Warnings
 
 	// Reject strange hacked games
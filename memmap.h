@@ -184,6 +184,17 @@
 #define MEMMAP_SHIFT		(12)
 #define MEMMAP_MASK			(MEMMAP_BLOCK_SIZE - 1)
 
+// What S9xGetByte and S9xSetByte need to know about one block of the
+// address space, so that an access is a single table lookup.
+struct SMemoryPage
+{
+	uint8	*Read;					// Map entry if it is memory, otherwise NULL and Get handles the block
+	uint8	*Write;					// same for WriteMap and Set
+	uint8	(*Get) (uint32);
+	void	(*Set) (uint8, uint32);
+	int32	Speed;					// master cycles per access, 0 if it varies within the block
+};
+
 struct CMemory
 {
 	enum
@@ -240,6 +251,8 @@ struct CMemory
 	uint8	*WriteMap[MEMMAP_NUM_BLOCKS];
 	uint8	BlockIsRAM[MEMMAP_NUM_BLOCKS];
 	uint8	BlockIsROM[MEMMAP_NUM_BLOCKS];
+	struct SMemoryPage	*Page;		// MEMMAP_NUM_BLOCKS entries, rebuilt by map_WriteProtectROM
+	uint8	*PageBuffer;
 	uint8	ExtendedFormat;
 
 	char	ROMFilename[PATH_MAX + 1];
@@ -306,6 +319,10 @@ struct CMemory
 	void	map_SetaRISC (void);
 	void	map_SetaDSP (void);
 	void	map_WriteProtectROM (void);
+	void	map_Pages (void);
+	void	map_Page (int);
+	void	map_Remap (int, uint8 *);
+	void	map_PageSpeeds (void);
 	void	Map_Initialize (void);
 	void	Map_LoROMMap (void);
 	void	Map_NoMAD1LoROMMap (void);
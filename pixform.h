@@ -183,6 +183,9 @@
 
 enum { RGB565, RGB555, BGR565, BGR555, GBR565, GBR555, RGB5551 };
 
+#define PIXEL_FORMATS					(RGB5551 + 1)
+#define PIXEL_FORMAT_INDEX				GFX.PixelFormat
+
 #define BUILD_PIXEL(R, G, B)					((*GFX.BuildPixel) (R, G, B))
 #define BUILD_PIXEL2(R, G, B)					((*GFX.BuildPixel2) (R, G, B))
 #define DECOMPOSE_PIXEL(PIX, R, G, B)			((*GFX.DecomposePixel) (PIX, R, G, B))
@@ -352,10 +355,48 @@ extern uint32	SPARE_RGB_BIT_MASK;
 #define THIRD_COLOR_MASK_RGB5551	0x003e
 #define ALPHA_BITS_MASK_RGB5551		0x0001
 
-#ifndef GFX_MULTI_FORMAT
+/* XRGB8888 format, each 5-bit colour widened to 8 bits so 32-bit displays can show the frame as it is */
+#define WIDEN_5_TO_8(C)							(((int) (C) << 3) | ((int) (C) >> 2))
+#define BUILD_PIXEL_XRGB8888(R, G, B)			((WIDEN_5_TO_8(R) << 16) | (WIDEN_5_TO_8(G) << 8) | WIDEN_5_TO_8(B))
+#define BUILD_PIXEL2_XRGB8888(R, G, B)			BUILD_PIXEL_XRGB8888(R, G, B)
+#define DECOMPOSE_PIXEL_XRGB8888(PIX, R, G, B)	{ (R) = ((PIX) >> 19) & 0x1f; (G) = ((PIX) >> 11) & 0x1f; (B) = ((PIX) >> 3) & 0x1f; }
+#define SPARE_RGB_BIT_MASK_XRGB8888				(1 << 24)
+
+#define MAX_RED_XRGB8888			31
+#define MAX_GREEN_XRGB8888			31
+#define MAX_BLUE_XRGB8888			31
+#define RED_LOW_BIT_MASK_XRGB8888	0x010000
+#define GREEN_LOW_BIT_MASK_XRGB8888	0x000100
+#define BLUE_LOW_BIT_MASK_XRGB8888	0x000001
+#define RED_HI_BIT_MASK_XRGB8888	0x800000
+#define GREEN_HI_BIT_MASK_XRGB8888	0x008000
+#define BLUE_HI_BIT_MASK_XRGB8888	0x000080
+#define FIRST_COLOR_MASK_XRGB8888	0xff0000
+#define SECOND_COLOR_MASK_XRGB8888	0x00ff00
+#define THIRD_COLOR_MASK_XRGB8888	0x0000ff
+#define ALPHA_BITS_MASK_XRGB8888	0x000000
+
+/* Pixel sizes; only a compile-time PIXEL_FORMAT can be XRGB8888 */
+#define PIXEL_BITS_RGB565			16
+#define PIXEL_BITS_RGB555			16
+#define PIXEL_BITS_BGR565			16
+#define PIXEL_BITS_BGR555			16
+#define PIXEL_BITS_GBR565			16
+#define PIXEL_BITS_GBR555			16
+#define PIXEL_BITS_RGB5551			16
+#define PIXEL_BITS_XRGB8888			32
+
+#ifdef GFX_MULTI_FORMAT
+#define PIXEL_BITS							16
+#endif
 
 #define CONCAT(X, Y)	X##Y
 
+#ifndef GFX_MULTI_FORMAT
+
+#define PIXEL_FORMATS						1
+#define PIXEL_FORMAT_INDEX					0
+
 // C pre-processor needs a two stage macro define to enable it to concat
 // to macro names together to form the name of another macro.
 #define BUILD_PIXEL_D(F, R, G, B)			CONCAT(BUILD_PIXEL_,F) (R, G, B)
@@ -380,6 +421,9 @@ extern uint32	SPARE_RGB_BIT_MASK;
 #define THIRD_COLOR_MASK_D(F)				CONCAT(THIRD_COLOR_MASK_, F)
 #define ALPHA_BITS_MASK_D(F)				CONCAT(ALPHA_BITS_MASK_, F)
 
+#define PIXEL_BITS_D(F)						CONCAT(PIXEL_BITS_, F)
+#define PIXEL_BITS							PIXEL_BITS_D(PIXEL_FORMAT)
+
 #define MAX_RED								MAX_RED_D(PIXEL_FORMAT)
 #define MAX_GREEN							MAX_GREEN_D(PIXEL_FORMAT)
 #define MAX_BLUE							MAX_BLUE_D(PIXEL_FORMAT)
@@ -405,4 +449,70 @@ extern uint32	SPARE_RGB_BIT_MASK;
 
 #endif
 
+// A pixel format as compile-time constants, for the code templated on it.
+// ID is the index the templates are instantiated with, F the format's name in the macros above.
+// Formats with the same colour masks name the same Math format, so they share their colour math code.
+
+template <int ID> struct PixelFormat;
+
+#define PIXEL_FORMAT_TRAITS(ID, F, M) \
+template <> struct PixelFormat<ID> \
+{ \
+	static const int	Math          = M; \
+	static const uint32	LowBits       = CONCAT(RED_LOW_BIT_MASK_, F) | CONCAT(GREEN_LOW_BIT_MASK_, F) | CONCAT(BLUE_LOW_BIT_MASK_, F); \
+	static const uint32	RemoveLowBits = ~LowBits; \
+	static const uint32	HiBits        = CONCAT(RED_HI_BIT_MASK_, F) | CONCAT(GREEN_HI_BIT_MASK_, F) | CONCAT(BLUE_HI_BIT_MASK_, F); \
+	static const uint32	HiBitsX2      = HiBits << 1; \
+	static const uint32	AlphaBits     = CONCAT(ALPHA_BITS_MASK_, F); \
+	static const uint32	FirstColor    = CONCAT(FIRST_COLOR_MASK_, F); \
+	static const uint32	SecondColor   = CONCAT(SECOND_COLOR_MASK_, F); \
+	static const uint32	ThirdColor    = CONCAT(THIRD_COLOR_MASK_, F); \
+	\
+	static uint32 Build (uint32 R, uint32 G, uint32 B) \
+	{ \
+		return (CONCAT(BUILD_PIXEL_, F) (R, G, B)); \
+	} \
+	\
+	static uint32 Build2 (uint32 R, uint32 G, uint32 B) \
+	{ \
+		return (CONCAT(BUILD_PIXEL2_, F) (R, G, B)); \
+	} \
+	\
+	static void Decompose (uint32 pixel, uint32 &R, uint32 &G, uint32 &B) \
+	{ \
+		CONCAT(DECOMPOSE_PIXEL_, F) (pixel, R, G, B); \
+	} \
+};
+
+#define PIXEL_FORMAT_SAME_MATH(F) \
+typedef char CONCAT(SameMath_, F)[(PixelFormat<F>::LowBits     == PixelFormat<PixelFormat<F>::Math>::LowBits     && \
+                                   PixelFormat<F>::HiBits      == PixelFormat<PixelFormat<F>::Math>::HiBits      && \
+                                   PixelFormat<F>::AlphaBits   == PixelFormat<PixelFormat<F>::Math>::AlphaBits   && \
+                                   PixelFormat<F>::FirstColor  == PixelFormat<PixelFormat<F>::Math>::FirstColor  && \
+                                   PixelFormat<F>::SecondColor == PixelFormat<PixelFormat<F>::Math>::SecondColor && \
+                                   PixelFormat<F>::ThirdColor  == PixelFormat<PixelFormat<F>::Math>::ThirdColor) ? 1 : -1];
+
+#ifdef GFX_MULTI_FORMAT
+PIXEL_FORMAT_TRAITS(RGB565,  RGB565,  RGB565)
+PIXEL_FORMAT_TRAITS(RGB555,  RGB555,  RGB555)
+PIXEL_FORMAT_TRAITS(BGR565,  BGR565,  BGR565)
+PIXEL_FORMAT_TRAITS(BGR555,  BGR555,  RGB555)
+PIXEL_FORMAT_TRAITS(GBR565,  GBR565,  BGR565)
+PIXEL_FORMAT_TRAITS(GBR555,  GBR555,  RGB555)
+PIXEL_FORMAT_TRAITS(RGB5551, RGB5551, RGB5551)
+
+PIXEL_FORMAT_SAME_MATH(BGR555)
+PIXEL_FORMAT_SAME_MATH(GBR565)
+PIXEL_FORMAT_SAME_MATH(GBR555)
+#else
+PIXEL_FORMAT_TRAITS(0, PIXEL_FORMAT, 0)
+#endif
+
+// What GFX.Screen and the colour maps are made of
+#if PIXEL_BITS == 32
+typedef uint32	pixel_t;
+#else
+typedef uint16	pixel_t;
+#endif
+
 #endif
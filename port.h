@@ -195,7 +195,10 @@
 #include <windows.h>
 #endif
 
+// A port can fix its pixel format at compile time with -DPIXEL_FORMAT=..., which XRGB8888 needs
+#ifndef PIXEL_FORMAT
 #define GFX_MULTI_FORMAT
+#endif
 
 #ifdef __WIN32__
 //#define RIGHTSHIFT_IS_SAR
@@ -277,6 +277,8 @@ void S9xUpdateHVTimerPosition (void)
 			PPU.VTimerPosition = 0;
 	}
 
+	S9xUpdateIRQTimerCheck();
+
 #ifdef DEBUGGER
 	S9xTraceFormattedMessage("--- IRQ Timer set  HTimer:%d Pos:%04d  VTimer:%d Pos:%03d",
 		PPU.HTimerEnabled, PPU.HTimerPosition, PPU.VTimerEnabled, PPU.VTimerPosition);
@@ -292,8 +294,9 @@ void S9xFixColourBrightness (void)
 		IPPU.Red[i]   = IPPU.XB[(PPU.CGDATA[i])       & 0x1f];
 		IPPU.Green[i] = IPPU.XB[(PPU.CGDATA[i] >>  5) & 0x1f];
 		IPPU.Blue[i]  = IPPU.XB[(PPU.CGDATA[i] >> 10) & 0x1f];
-		IPPU.ScreenColors[i] = BUILD_PIXEL(IPPU.Red[i], IPPU.Green[i], IPPU.Blue[i]);
 	}
+
+	S9xBuildScreenColors();
 }
 
 void S9xSetPPU (uint8 Byte, uint16 Address)
@@ -1053,7 +1056,10 @@ void S9xSetPPU (uint8 Byte, uint16 Address)
 		if (Settings.SA1     && Address >= 0x2200)
 		{
 			if (Address <= 0x23ff)
+			{
+				S9xSA1Sync();
 				S9xSetSA1(Byte, Address);
+			}
 			else
 				Memory.FillRAM[Address] = Byte;
 			return;
@@ -1317,7 +1323,10 @@ uint8 S9xGetPPU (uint16 Address)
 			return (S9xGetSuperFX(Address));
 		else
 		if (Settings.SA1     && Address >= 0x2200)
+		{
+			S9xSA1Sync();
 			return (S9xGetSA1(Address));
+		}
 		else
 		if (Settings.BS      && Address >= 0x2188 && Address <= 0x219f)
 			return (S9xGetBSXPPU(Address));
@@ -1479,6 +1488,8 @@ void S9xSetCPU (uint8 Byte, uint16 Address)
 				else
 					PPU.HTimerEnabled = FALSE;
 
+				S9xUpdateIRQTimerCheck();
+
 				if (CPU.IRQLine && !PPU.HTimerEnabled && PPU.VTimerEnabled)
 					CPU.IRQTransition = TRUE;
 
@@ -1629,6 +1640,8 @@ void S9xSetCPU (uint8 Byte, uint16 Address)
 					}
 					else
 						CPU.FastROMSpeed = SLOW_ONE_CYCLE;
+
+					Memory.map_PageSpeeds();
 				}
 
 				break;
@@ -1954,6 +1967,7 @@ void S9xSoftResetPPU (void)
 	ZeroMemory(IPPU.TileCached[TILE_2BIT_ODD],  MAX_2BIT_TILES);
 	ZeroMemory(IPPU.TileCached[TILE_4BIT_EVEN], MAX_4BIT_TILES);
 	ZeroMemory(IPPU.TileCached[TILE_4BIT_ODD],  MAX_4BIT_TILES);
+	IPPU.VRAMChanged = TRUE;
 	IPPU.VRAMReadBuffer = 0; // XXX: FIXME: anything better?
 	IPPU.Interlace = FALSE;
 	IPPU.InterlaceOBJ = FALSE;
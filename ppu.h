@@ -211,7 +211,9 @@ struct InternalPPU
 	struct ClipData Clip[2][6];
 	bool8	ColorsChanged;
 	bool8	OBJChanged;
+	uint32	OBJDirty[4];	// sprites moved or resized since SetupOBJ, one bit each
 	bool8	DirectColourMapsNeedRebuild;
+	bool8	VRAMChanged;
 	uint8	*TileCache[7];
 	uint8	*TileCached[7];
 	uint16	VRAMReadBuffer;
@@ -226,7 +228,7 @@ struct InternalPPU
 	uint32	Red[256];
 	uint32	Green[256];
 	uint32	Blue[256];
-	uint16	ScreenColors[256];
+	pixel_t	ScreenColors[256];
 	uint8	MaxBrightness;
 	bool8	RenderThisFrame;
 	int		RenderedScreenWidth;
@@ -367,8 +369,6 @@ struct SPPU
 };
 
 extern uint16				SignExtend[2];
-extern struct SPPU			PPU;
-extern struct InternalPPU	IPPU;
 
 void S9xResetPPU (void);
 void S9xSoftResetPPU (void);
@@ -381,6 +381,10 @@ void S9xFixColourBrightness (void);
 void S9xDoAutoJoypad (void);
 
 #include "gfx.h"
+
+extern GFX_THREAD_LOCAL struct SPPU			PPU;
+extern GFX_THREAD_LOCAL struct InternalPPU	IPPU;
+
 #include "memmap.h"
 
 typedef struct
@@ -412,11 +416,14 @@ static inline void REGISTER_2104 (uint8 Byte)
 		if (Byte != PPU.OAMData[addr])
 		{
 			FLUSH_REDRAW();
+			uint8	changed = Byte ^ PPU.OAMData[addr];
 			PPU.OAMData[addr] = Byte;
-			IPPU.OBJChanged = TRUE;
 
 			// X position high bit, and sprite size (x4)
-			struct SOBJ *pObj = &PPU.OBJ[(addr & 0x1f) * 4];
+			int		S = (addr & 0x1f) * 4;
+			IPPU.OBJDirty[S >> 5] |= (((changed & 0x03) ? 1 : 0) | ((changed & 0x0c) ? 2 : 0) | ((changed & 0x30) ? 4 : 0) | ((changed & 0xc0) ? 8 : 0)) << (S & 31);
+
+			struct SOBJ *pObj = &PPU.OBJ[S];
 			pObj->HPos = (pObj->HPos & 0xFF) | SignExtend[(Byte >> 0) & 1];
 			pObj++->Size = Byte & 2;
 			pObj->HPos = (pObj->HPos & 0xFF) | SignExtend[(Byte >> 2) & 1];
@@ -464,9 +471,11 @@ static inline void REGISTER_2104 (uint8 Byte)
 		if (lowbyte != PPU.OAMData[addr] || highbyte != PPU.OAMData[addr + 1])
 		{
 			FLUSH_REDRAW();
+			// Only position, size and vertical flip decide which sprites are on which lines
+			if (!(addr & 2) || ((highbyte ^ PPU.OAMData[addr + 1]) & 0x80))
+				IPPU.OBJDirty[addr >> 7] |= 1 << ((addr >> 2) & 31);
 			PPU.OAMData[addr] = lowbyte;
 			PPU.OAMData[addr + 1] = highbyte;
-			IPPU.OBJChanged = TRUE;
 			if (addr & 2)
 			{
 				// Tile
@@ -527,6 +536,7 @@ static inline void REGISTER_2118 (uint8 Byte)
 	else
 		Memory.VRAM[address = (PPU.VMA.Address << 1) & 0xffff] = Byte;
 
+	IPPU.VRAMChanged = TRUE;
 	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
 	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
 	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
@@ -564,6 +574,7 @@ static inline void REGISTER_2119 (uint8 Byte)
 	else
 		Memory.VRAM[address = ((PPU.VMA.Address << 1) + 1) & 0xffff] = Byte;
 
+	IPPU.VRAMChanged = TRUE;
 	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
 	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
 	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
@@ -595,6 +606,7 @@ static inline void REGISTER_2118_tile (uint8 Byte)
 
 	Memory.VRAM[address] = Byte;
 
+	IPPU.VRAMChanged = TRUE;
 	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
 	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
 	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
@@ -620,6 +632,7 @@ static inline void REGISTER_2119_tile (uint8 Byte)
 
 	Memory.VRAM[address] = Byte;
 
+	IPPU.VRAMChanged = TRUE;
 	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
 	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
 	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
@@ -644,6 +657,7 @@ static inline void REGISTER_2118_linear (uint8 Byte)
 
 	Memory.VRAM[address = (PPU.VMA.Address << 1) & 0xffff] = Byte;
 
+	IPPU.VRAMChanged = TRUE;
 	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
 	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
 	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
@@ -668,6 +682,7 @@ static inline void REGISTER_2119_linear (uint8 Byte)
 
 	Memory.VRAM[address = ((PPU.VMA.Address << 1) + 1) & 0xffff] = Byte;
 
+	IPPU.VRAMChanged = TRUE;
 	IPPU.TileCached[TILE_2BIT][address >> 4] = FALSE;
 	IPPU.TileCached[TILE_4BIT][address >> 5] = FALSE;
 	IPPU.TileCached[TILE_8BIT][address >> 6] = FALSE;
@@ -696,7 +711,7 @@ static inline void REGISTER_2122 (uint8 Byte)
 			IPPU.ColorsChanged = TRUE;
 			IPPU.Blue[PPU.CGADD] = IPPU.XB[(Byte >> 2) & 0x1f];
 			IPPU.Green[PPU.CGADD] = IPPU.XB[(PPU.CGDATA[PPU.CGADD] >> 5) & 0x1f];
-			IPPU.ScreenColors[PPU.CGADD] = (uint16) BUILD_PIXEL(IPPU.Red[PPU.CGADD], IPPU.Green[PPU.CGADD], IPPU.Blue[PPU.CGADD]);
+			IPPU.ScreenColors[PPU.CGADD] = (pixel_t) BUILD_PIXEL(IPPU.Red[PPU.CGADD], IPPU.Green[PPU.CGADD], IPPU.Blue[PPU.CGADD]);
 		}
 
 		PPU.CGADD++;
@@ -711,7 +726,7 @@ static inline void REGISTER_2122 (uint8 Byte)
 			IPPU.ColorsChanged = TRUE;
 			IPPU.Red[PPU.CGADD] = IPPU.XB[Byte & 0x1f];
 			IPPU.Green[PPU.CGADD] = IPPU.XB[(PPU.CGDATA[PPU.CGADD] >> 5) & 0x1f];
-			IPPU.ScreenColors[PPU.CGADD] = (uint16) BUILD_PIXEL(IPPU.Red[PPU.CGADD], IPPU.Green[PPU.CGADD], IPPU.Blue[PPU.CGADD]);
+			IPPU.ScreenColors[PPU.CGADD] = (pixel_t) BUILD_PIXEL(IPPU.Red[PPU.CGADD], IPPU.Green[PPU.CGADD], IPPU.Blue[PPU.CGADD]);
 		}
 	}
 
@@ -194,6 +194,7 @@ void S9xSA1Init (void)
 	SA1.PrevCycles = 0;
 	SA1.Flags = 0;
 	SA1.WaitingForInterrupt = FALSE;
+	SA1.PendingSteps = 0;
 
 	memset(&Memory.FillRAM[0x2200], 0, 0x200);
 	Memory.FillRAM[0x2200] = 0x20;
@@ -303,14 +304,20 @@ static void S9xSetSA1MemMap (uint32 which1, uint8 map)
 	{
 		uint8	*block = &Memory.ROM[(map & 7) * 0x100000 + (c << 12)];
 		for (int i = c; i < c + 16; i++)
-			Memory.Map[start  + i] = SA1.Map[start  + i] = block;
+		{
+			SA1.Map[start  + i] = block;
+			Memory.map_Remap(start  + i, block);
+		}
 	}
 
 	for (int c = 0; c < 0x200; c += 16)
 	{
 		uint8	*block = &Memory.ROM[(map & 7) * 0x100000 + (c << 11) - 0x8000];
 		for (int i = c + 8; i < c + 16; i++)
-			Memory.Map[start2 + i] = SA1.Map[start2 + i] = block;
+		{
+			SA1.Map[start2 + i] = block;
+			Memory.map_Remap(start2 + i, block);
+		}
 	}
 }
 
@@ -207,6 +207,7 @@ struct SSA1
 	int32	PrevCycles;
 	uint8	*PCBase;
 	bool8	WaitingForInterrupt;
+	int32	PendingSteps;	// S9xSA1MainLoop calls the S-CPU has run ahead of
 
 	uint8	*Map[MEMMAP_NUM_BLOCKS];
 	uint8	*WriteMap[MEMMAP_NUM_BLOCKS];
@@ -265,8 +266,17 @@ uint8 S9xGetSA1 (uint32);
 void S9xSetSA1 (uint8, uint32);
 void S9xSA1Init (void);
 void S9xSA1MainLoop (void);
+void S9xSA1CatchUp (void);
 void S9xSA1PostLoadState (void);
 
+// With Settings.SA1TimeSlice the S-CPU only counts the SA-1 steps it owes,
+// and pays them before it touches anything the SA-1 can see or change.
+static inline void S9xSA1Sync (void)
+{
+	if (SA1.PendingSteps)
+		S9xSA1CatchUp();
+}
+
 static inline void S9xSA1UnpackStatus (void)
 {
 	SA1._Zero = (SA1Registers.PL & Zero) == 0;
@@ -334,6 +334,16 @@ void S9xSA1MainLoop (void)
 	S9xSA1UpdateTimer();
 }
 
+void S9xSA1CatchUp (void)
+{
+	int32	steps = SA1.PendingSteps;
+
+	SA1.PendingSteps = 0;
+
+	while (steps--)
+		S9xSA1MainLoop();
+}
+
 static void S9xSA1UpdateTimer (void) // FIXME
 {
 	SA1.PrevHCounter = SA1.HCounter;
@@ -266,7 +266,7 @@ bool8 S9xDoScreenshot (int width, int height)
 	png_set_packing(png_ptr);
 
 	png_byte	*row_pointer = new png_byte[png_get_rowbytes(png_ptr, info_ptr)];
-	uint16		*screen = GFX.Screen;
+	pixel_t		*screen = GFX.Screen;
 
 	for (int y = 0; y < height; y++, screen += GFX.RealPPL)
 	{
@@ -191,7 +191,7 @@ void S9xSetSDD1MemoryMap (uint32 bank, uint32 value)
 	{
 		uint8	*block = &Memory.ROM[value + (c << 12)];
 		for (int i = c; i < c + 16; i++)
-			Memory.Map[i + bank] = block;
+			Memory.map_Remap(i + bank, block);
 	}
 }
 
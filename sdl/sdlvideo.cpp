@@ -173,11 +173,18 @@ void S9xInitDisplay (int argc, char **argv)
 	 * we just go along with RGB565 for now, nothing else..
 	 */
 	
+#ifdef GFX_MULTI_FORMAT
 	S9xSetRenderPixelFormat(RGB565);
+#endif
 	
 	S9xBlitFilterInit();
+#if PIXEL_BITS == 16
 	S9xBlit2xSaIFilterInit();
 	S9xBlitHQ2xFilterInit();
+#else
+	// The scaling filters only know 16-bit pixels
+	GUI.video_mode = VIDEOMODE_BLOCKY;
+#endif
 	/*
 	 * jtokarchuk
 	 * Hides the mouse cursor onscreen.
@@ -192,9 +199,9 @@ void S9xInitDisplay (int argc, char **argv)
 	 */	
         if (GUI.fullscreen == TRUE)
         {
-                GUI.sdl_screen = SDL_SetVideoMode(0, 0, 16, SDL_FULLSCREEN);
+                GUI.sdl_screen = SDL_SetVideoMode(0, 0, PIXEL_BITS, SDL_FULLSCREEN);
         } else {
-                GUI.sdl_screen = SDL_SetVideoMode(SNES_WIDTH * 2, SNES_HEIGHT_EXTENDED * 2, 16, 0);
+                GUI.sdl_screen = SDL_SetVideoMode(SNES_WIDTH * 2, SNES_HEIGHT_EXTENDED * 2, PIXEL_BITS, 0);
         }
 
         if (GUI.sdl_screen == NULL)
@@ -218,8 +225,10 @@ void S9xDeinitDisplay (void)
 	SDL_Quit();
 
 	S9xBlitFilterDeinit();
+#if PIXEL_BITS == 16
 	S9xBlit2xSaIFilterDeinit();
 	S9xBlitHQ2xFilterDeinit();
+#endif
 }
 
 static void TakedownImage (void)
@@ -239,13 +248,13 @@ static void SetupImage (void)
 
 	// domaemon: The whole unix code basically assumes output=(original * 2);
 	// This way the code can handle the SNES filters, which does the 2X.
-	GFX.Pitch = SNES_WIDTH * 2 * 2;
+	GFX.Pitch = SNES_WIDTH * 2 * sizeof(pixel_t);
 	GUI.snes_buffer = (uint8 *) calloc(GFX.Pitch * ((SNES_HEIGHT_EXTENDED + 4) * 2), 1);
 	if (!GUI.snes_buffer)
 		FatalError("Failed to allocate GUI.snes_buffer.");
 
 	// domaemon: Add 2 lines before drawing.
-	GFX.Screen = (uint16 *) (GUI.snes_buffer + (GFX.Pitch * 2 * 2));
+	GFX.Screen = (pixel_t *) (GUI.snes_buffer + (GFX.Pitch * 2 * 2));
 
 	if (GUI.fullscreen == TRUE)
 	{
@@ -257,15 +266,15 @@ static void SetupImage (void)
 		offset_height_pix = (GUI.sdl_screen->h - (SNES_HEIGHT * 2)) / 2;
 		offset_width_pix = (GUI.sdl_screen->w - (SNES_WIDTH * 2)) / 2;
 		
-		offset_byte = (GUI.sdl_screen->w * offset_height_pix + offset_width_pix) * 2;
+		offset_byte = (GUI.sdl_screen->w * offset_height_pix + offset_width_pix) * sizeof(pixel_t);
 
 		GUI.blit_screen       = (uint8 *) GUI.sdl_screen->pixels + offset_byte;
-		GUI.blit_screen_pitch = GUI.sdl_screen->w * 2;
+		GUI.blit_screen_pitch = GUI.sdl_screen->w * sizeof(pixel_t);
 	}
 	else 
 	{
 		GUI.blit_screen       = (uint8 *) GUI.sdl_screen->pixels;
-		GUI.blit_screen_pitch = SNES_WIDTH * 2 * 2; // window size =(*2); 2 byte pir pixel =(*2)
+		GUI.blit_screen_pitch = SNES_WIDTH * 2 * sizeof(pixel_t); // window size =(*2); bytes per pixel
 	}
 
 	S9xGraphicsInit();
@@ -297,6 +306,7 @@ void S9xPutImage (int width, int height)
 			switch (GUI.video_mode)
 			{
 				case VIDEOMODE_BLOCKY:		blitFn = S9xBlitPixSimple2x2;		break;
+			#if PIXEL_BITS == 16
 				case VIDEOMODE_TV:			blitFn = S9xBlitPixTV2x2;			break;
 				case VIDEOMODE_SMOOTH:		blitFn = S9xBlitPixSmooth2x2;		break;
 				case VIDEOMODE_SUPEREAGLE:	blitFn = S9xBlitPixSuperEagle16;	break;
@@ -304,6 +314,7 @@ void S9xPutImage (int width, int height)
 				case VIDEOMODE_SUPER2XSAI:	blitFn = S9xBlitPixSuper2xSaI16;	break;
 				case VIDEOMODE_EPX:			blitFn = S9xBlitPixEPX16;			break;
 				case VIDEOMODE_HQ2X:		blitFn = S9xBlitPixHQ2x16;			break;
+			#endif
 			}
 		}
 	}
@@ -316,7 +327,9 @@ void S9xPutImage (int width, int height)
 		switch (GUI.video_mode)
 		{
 			default:					blitFn = S9xBlitPixSimple1x2;	break;
+		#if PIXEL_BITS == 16
 			case VIDEOMODE_TV:			blitFn = S9xBlitPixTV1x2;		break;
+		#endif
 		}
 	}
 	else
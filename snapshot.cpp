@@ -1368,7 +1368,7 @@ void S9xFreezeToStream (STREAM stream)
 		ssi->Interlaced = GFX.DoInterlace;
 
 		uint8	*rowpix = ssi->Data;
-		uint16	*screen = GFX.Screen;
+		pixel_t	*screen = GFX.Screen;
 
 		for (int y = 0; y < ssi->Height; y++, screen += GFX.RealPPL)
 		{
@@ -1701,6 +1701,7 @@ int S9xUnfreezeFromStream (STREAM stream)
 			if (local_sa1) // FIXME
 			{
 				SA1.Cycles = SA1.PrevCycles = 0;
+				SA1.PendingSteps = 0;
 				SA1.TimerIRQLastState = FALSE;
 				SA1.HTimerIRQPos = Memory.FillRAM[0x2212] | (Memory.FillRAM[0x2213] << 8);
 				SA1.VTimerIRQPos = Memory.FillRAM[0x2214] | (Memory.FillRAM[0x2215] << 8);
@@ -1715,9 +1716,12 @@ int S9xUnfreezeFromStream (STREAM stream)
 		CPU.Flags |= old_flags & (DEBUG_MODE_FLAG | TRACE_FLAG | SINGLE_STEP_FLAG | FRAME_ADVANCE_FLAG);
 		ICPU.ShiftedPB = Registers.PB << 16;
 		ICPU.ShiftedDB = Registers.DB << 16;
+		Memory.map_PageSpeeds();
+		IdleLoop.Decoded = IdleLoop.Seen = FALSE;
 		S9xSetPCBase(Registers.PBPC);
 		S9xUnpackStatus();
 		S9xFixCycles();
+		S9xUpdateIRQTimerCheck();
 
 		for (int d = 0; d < 8; d++)
 			DMA[d] = dma_snap.dma[d];
@@ -1783,7 +1787,7 @@ int S9xUnfreezeFromStream (STREAM stream)
 			GFX.DoInterlace = Settings.SupportHiRes ? ssi->Interlaced : 0;
 
 			uint8	*rowpix = ssi->Data;
-			uint16	*screen = GFX.Screen;
+			pixel_t	*screen = GFX.Screen;
 
 			for (int y = 0; y < IPPU.RenderedScreenHeight; y++, screen += GFX.RealPPL)
 			{
@@ -1818,7 +1822,7 @@ int S9xUnfreezeFromStream (STREAM stream)
 
 			// black out what we might have missed
 			for (uint32 y = IPPU.RenderedScreenHeight; y < (uint32) (IMAGE_HEIGHT); y++)
-				memset(GFX.Screen + y * GFX.RealPPL, 0, GFX.RealPPL * 2);
+				memset(GFX.Screen + y * GFX.RealPPL, 0, GFX.RealPPL * sizeof(pixel_t));
 
 			delete ssi;
 		}
@@ -1826,9 +1830,11 @@ int S9xUnfreezeFromStream (STREAM stream)
 		{
 			// couldn't load graphics, so black out the screen instead
 			for (uint32 y = 0; y < (uint32) (IMAGE_HEIGHT); y++)
-				memset(GFX.Screen + y * GFX.RealPPL, 0, GFX.RealPPL * 2);
+				memset(GFX.Screen + y * GFX.RealPPL, 0, GFX.RealPPL * sizeof(pixel_t));
 		}
 
+		S9xRedrawAllLines();
+
 		S9xSetSoundMute(FALSE);
 	}
 
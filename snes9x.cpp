@@ -419,6 +419,9 @@ void S9xLoadConfigFiles (char **argv, int argc)
 	Settings.SupportHiRes               =  conf.GetBool("Display::HiRes",                      true);
 	Settings.Transparency               =  conf.GetBool("Display::Transparency",               true);
 	Settings.DisableGraphicWindows      = !conf.GetBool("Display::GraphicWindows",             true);
+	Settings.RenderThreads              =  conf.GetUInt("Display::RenderThreads",              1);
+	Settings.PipelinedRendering         =  conf.GetBool("Display::PipelinedRendering",         false);
+	Settings.ReuseUnchangedLines        =  conf.GetBool("Display::ReuseUnchangedLines",        false);
 	Settings.DisplayFrameRate           =  conf.GetBool("Display::DisplayFrameRate",           false);
 	Settings.DisplayWatchedAddresses    =  conf.GetBool("Display::DisplayWatchedAddresses",    false);
 	Settings.DisplayPressedKeys         =  conf.GetBool("Display::DisplayInput",               false);
@@ -477,6 +480,15 @@ void S9xLoadConfigFiles (char **argv, int argc)
 	Settings.DisableGameSpecificHacks       = !conf.GetBool("Hack::EnableGameSpecificHacks",       true);
 	Settings.BlockInvalidVRAMAccessMaster   = !conf.GetBool("Hack::AllowInvalidVRAMAccess",        false);
 	Settings.HDMATimingHack                 =  conf.GetInt ("Hack::HDMATiming",                    100);
+	Settings.SkipIdleLoopsMaster            =  conf.GetBool("Hack::SpeedHacks",                    false);
+	Settings.SkipIdleLoopsOn[0] = '\0';
+	if (conf.Exists("Hack::SpeedHacksOn"))
+		conf.GetString("Hack::SpeedHacksOn", Settings.SkipIdleLoopsOn, sizeof(Settings.SkipIdleLoopsOn));
+	Settings.SkipIdleLoopsOff[0] = '\0';
+	if (conf.Exists("Hack::SpeedHacksOff"))
+		conf.GetString("Hack::SpeedHacksOff", Settings.SkipIdleLoopsOff, sizeof(Settings.SkipIdleLoopsOff));
+	Settings.SA1TimeSlice                   =  conf.GetBool("Hack::SA1TimeSlice",                  false);
+	Settings.BlockDispatch                  =  conf.GetBool("Hack::BlockDispatch",                 false);
 
 	// Netplay
 
@@ -534,6 +546,14 @@ void S9xUsage (void)
 	S9xMessage(S9X_INFO, S9X_USAGE, "-displaykeypress                Display input of all controllers and peripherals");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-nohires                        (Not recommended) Disable support for hi-res and");
 	S9xMessage(S9X_INFO, S9X_USAGE, "                                interlace modes");
+#ifdef USE_THREADS
+	S9xMessage(S9X_INFO, S9X_USAGE, "-renderthreads <num>            Split screen drawing across this many threads");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-pipelinedrendering             Draw each frame on a separate thread while the next");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                one is emulated (shows frames one frame late,");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                not used with -reuselines)");
+#endif
+	S9xMessage(S9X_INFO, S9X_USAGE, "-reuselines                     Leave lines that would come out the same as last");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                frame undrawn");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-notransparency                 (Not recommended) Disable transparency effects");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-nowindows                      (Not recommended) Disable graphic window effects");
 	S9xMessage(S9X_INFO, S9X_USAGE, "");
@@ -595,6 +615,12 @@ void S9xUsage (void)
 	S9xMessage(S9X_INFO, S9X_USAGE, "-hdmatiming <1-199>             (Not recommended) Changes HDMA transfer timings");
 	S9xMessage(S9X_INFO, S9X_USAGE, "                                event comes");
 	S9xMessage(S9X_INFO, S9X_USAGE, "-invalidvramaccess              (Not recommended) Allow invalid VRAM access");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-speedhacks                     Skip CPU loops that only wait for the next");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                event");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-sa1timeslice                   (Not recommended) Run the SA-1 in batches, in step");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                with the S-CPU only where they share data");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-blockdispatch                  Run straight-line CPU code without checking for");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                interrupts after every instruction");
 	S9xMessage(S9X_INFO, S9X_USAGE, "");
 
 	// OTHER OPTIONS
@@ -683,6 +709,20 @@ char * S9xParseArgs (char **argv, int argc)
 			if (!strcasecmp(argv[i], "-nowindows"))
 				Settings.DisableGraphicWindows = TRUE;
 			else
+			if (!strcasecmp(argv[i], "-renderthreads"))
+			{
+				if (i + 1 < argc)
+					Settings.RenderThreads = atoi(argv[++i]);
+				else
+					S9xUsage();
+			}
+			else
+			if (!strcasecmp(argv[i], "-pipelinedrendering"))
+				Settings.PipelinedRendering = TRUE;
+			else
+			if (!strcasecmp(argv[i], "-reuselines"))
+				Settings.ReuseUnchangedLines = TRUE;
+			else
 
 			// CONTROLLER OPTIONS
 
@@ -869,6 +909,15 @@ char * S9xParseArgs (char **argv, int argc)
 			if (!strcasecmp(argv[i], "-invalidvramaccess"))
 				Settings.BlockInvalidVRAMAccessMaster = FALSE;
 			else
+			if (!strcasecmp(argv[i], "-speedhacks"))
+				Settings.SkipIdleLoopsMaster = TRUE;
+			else
+			if (!strcasecmp(argv[i], "-sa1timeslice"))
+				Settings.SA1TimeSlice = TRUE;
+			else
+			if (!strcasecmp(argv[i], "-blockdispatch"))
+				Settings.BlockDispatch = TRUE;
+			else
 
 			// OTHER OPTIONS
 
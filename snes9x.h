@@ -293,6 +293,7 @@ struct SCPUState
 	int32	CurrentDMAorHDMAChannel;
 	uint8	WhichEvent;
 	int32	NextEvent;
+	int32	NextIRQTimerCheck;
 	bool8	WaitingForInterrupt;
 	uint32	AutoSaveTimer;
 	bool8	SRAMModified;
@@ -384,6 +385,9 @@ struct SSettings
 	bool8	Transparency;
 	uint8	BG_Forced;
 	bool8	DisableGraphicWindows;
+	uint32	RenderThreads;
+	bool8	PipelinedRendering;
+	bool8	ReuseUnchangedLines;
 
 	bool8	DisplayFrameRate;
 	bool8	DisplayWatchedAddresses;
@@ -391,7 +395,7 @@ struct SSettings
 	bool8	DisplayMovieFrame;
 	bool8	AutoDisplayMessages;
 	uint32	InitialInfoStringTimeout;
-	uint16	DisplayColor;
+	uint32	DisplayColor;
 
 	bool8	Multi;
 	char	CartAName[PATH_MAX + 1];
@@ -400,6 +404,12 @@ struct SSettings
 	bool8	DisableGameSpecificHacks;
 	bool8	BlockInvalidVRAMAccessMaster;
 	bool8	BlockInvalidVRAMAccess;
+	bool8	SkipIdleLoopsMaster;
+	bool8	SkipIdleLoops;
+	char	SkipIdleLoopsOn[256];
+	char	SkipIdleLoopsOff[256];
+	bool8	SA1TimeSlice;
+	bool8	BlockDispatch;
 	int32	HDMATimingHack;
 
 	bool8	ForcedPause;
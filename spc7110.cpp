@@ -230,17 +230,17 @@ static void SetSPC7110SRAMMap (uint8 newstate)
 {
 	if (newstate & 0x80)
 	{
-		Memory.Map[0x006] = (uint8 *) Memory.MAP_HIROM_SRAM;
-		Memory.Map[0x007] = (uint8 *) Memory.MAP_HIROM_SRAM;
-		Memory.Map[0x306] = (uint8 *) Memory.MAP_HIROM_SRAM;
-		Memory.Map[0x307] = (uint8 *) Memory.MAP_HIROM_SRAM;
+		Memory.map_Remap(0x006, (uint8 *) Memory.MAP_HIROM_SRAM);
+		Memory.map_Remap(0x007, (uint8 *) Memory.MAP_HIROM_SRAM);
+		Memory.map_Remap(0x306, (uint8 *) Memory.MAP_HIROM_SRAM);
+		Memory.map_Remap(0x307, (uint8 *) Memory.MAP_HIROM_SRAM);
 	}
 	else
 	{
-		Memory.Map[0x006] = (uint8 *) Memory.MAP_RONLY_SRAM;
-		Memory.Map[0x007] = (uint8 *) Memory.MAP_RONLY_SRAM;
-		Memory.Map[0x306] = (uint8 *) Memory.MAP_RONLY_SRAM;
-		Memory.Map[0x307] = (uint8 *) Memory.MAP_RONLY_SRAM;
+		Memory.map_Remap(0x006, (uint8 *) Memory.MAP_RONLY_SRAM);
+		Memory.map_Remap(0x007, (uint8 *) Memory.MAP_RONLY_SRAM);
+		Memory.map_Remap(0x306, (uint8 *) Memory.MAP_RONLY_SRAM);
+		Memory.map_Remap(0x307, (uint8 *) Memory.MAP_RONLY_SRAM);
 	}
 }
 
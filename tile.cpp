@@ -189,10 +189,39 @@
 #include "ppu.h"
 #include "tile.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TILE_SSE2
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#include <tmmintrin.h>
+#define TILE_SSSE3
+#endif
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define TILE_NEON
+#endif
+
 static uint32	pixbit[8][16];
 static uint8	hrbit_odd[256];
 static uint8	hrbit_even[256];
 
+static uint8 ConvertPlanesC (uint8 *, const uint8 *, int);
+#ifdef TILE_SSE2
+static uint8 ConvertPlanesSSE2 (uint8 *, const uint8 *, int);
+#endif
+#ifdef TILE_SSSE3
+__attribute__((target("ssse3"))) static uint8 ConvertPlanesSSSE3 (uint8 *, const uint8 *, int);
+#endif
+#ifdef TILE_NEON
+static uint8 ConvertPlanesNEON (uint8 *, const uint8 *, int);
+#endif
+
+static uint8	(*ConvertPlanes) (uint8 *, const uint8 *, int) = ConvertPlanesC;
+
+#ifdef TILE_SSE2
+#define TILE_VECTOR_MATH
+#endif
+
 
 void S9xInitTileRenderer (void)
 {
@@ -251,10 +280,21 @@ void S9xInitTileRenderer (void)
 		hrbit_odd[i]  = m;
 		hrbit_even[i] = s;
 	}
+
+#if defined(TILE_NEON)
+	ConvertPlanes = ConvertPlanesNEON;
+#elif defined(TILE_SSE2)
+	ConvertPlanes = ConvertPlanesSSE2;
+#ifdef TILE_SSSE3
+	if (__builtin_cpu_supports("ssse3"))
+		ConvertPlanes = ConvertPlanesSSSE3;
+#endif
+#endif
 }
 
 // Here are the tile converters, selected by S9xSelectTileConverter().
-// Really, except for the definition of DOBIT and the number of times it is called, they're all the same.
+// They all come down to ConvertPlanes(), which turns pairs of bitplanes, laid out row by row as in VRAM,
+// into one byte per pixel. The hires ones first pack the odd or even pixels of two tiles into one.
 
 #define DOBIT(n, i) \
 	if ((pix = *(tp + (n)))) \
@@ -263,9 +303,8 @@ void S9xInitTileRenderer (void)
 		p2 |= pixbit[(i)][pix & 0xf]; \
 	}
 
-static uint8 ConvertTile2 (uint8 *pCache, uint32 TileAddr, uint32)
+static uint8 ConvertPlanesC (uint8 *pCache, const uint8 *tp, int pairs)
 {
-	register uint8	*tp      = &Memory.VRAM[TileAddr];
 	uint32			*p       = (uint32 *) pCache;
 	uint32			non_zero = 0;
 	uint8			line;
@@ -278,6 +317,18 @@ static uint8 ConvertTile2 (uint8 *pCache, uint32 TileAddr, uint32)
 
 		DOBIT( 0, 0);
 		DOBIT( 1, 1);
+		if (pairs > 1)
+		{
+			DOBIT(16, 2);
+			DOBIT(17, 3);
+			if (pairs > 2)
+			{
+				DOBIT(32, 4);
+				DOBIT(33, 5);
+				DOBIT(48, 6);
+				DOBIT(49, 7);
+			}
+		}
 		*p++ = p1;
 		*p++ = p2;
 		non_zero |= p1 | p2;
@@ -286,193 +337,232 @@ static uint8 ConvertTile2 (uint8 *pCache, uint32 TileAddr, uint32)
 	return (non_zero ? TRUE : BLANK_TILE);
 }
 
-static uint8 ConvertTile4 (uint8 *pCache, uint32 TileAddr, uint32)
-{
-	register uint8	*tp      = &Memory.VRAM[TileAddr];
-	uint32			*p       = (uint32 *) pCache;
-	uint32			non_zero = 0;
-	uint8			line;
-
-	for (line = 8; line != 0; line--, tp += 2)
-	{
-		uint32			p1 = 0;
-		uint32			p2 = 0;
-		register uint8	pix;
+#undef DOBIT
 
-		DOBIT( 0, 0);
-		DOBIT( 1, 1);
-		DOBIT(16, 2);
-		DOBIT(17, 3);
-		*p++ = p1;
-		*p++ = p2;
-		non_zero |= p1 | p2;
-	}
+// The vector converters spread each row's plane byte across the row's 8 pixels, then test one bit per pixel.
+// Each register holds two rows, so a tile is 4 registers whatever its depth.
 
-	return (non_zero ? TRUE : BLANK_TILE);
-}
+#ifdef TILE_SSE2
 
-static uint8 ConvertTile8 (uint8 *pCache, uint32 TileAddr, uint32)
+static uint8 ConvertPlanesSSE2 (uint8 *pCache, const uint8 *tp, int pairs)
 {
-	register uint8	*tp      = &Memory.VRAM[TileAddr];
-	uint32			*p       = (uint32 *) pCache;
-	uint32			non_zero = 0;
-	uint8			line;
+	const __m128i	bits = _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+	const __m128i	zero = _mm_setzero_si128();
+	__m128i			out[4] = { zero, zero, zero, zero };
+	__m128i			any = zero;
 
-	for (line = 8; line != 0; line--, tp += 2)
+	for (int k = 0; k < pairs; k++, tp += 16)
 	{
-		uint32			p1 = 0;
-		uint32			p2 = 0;
-		register uint8	pix;
+		__m128i	v = _mm_loadu_si128((const __m128i *) tp);
+		any = _mm_or_si128(any, v);
 
-		DOBIT( 0, 0);
-		DOBIT( 1, 1);
-		DOBIT(16, 2);
-		DOBIT(17, 3);
-		DOBIT(32, 4);
-		DOBIT(33, 5);
-		DOBIT(48, 6);
-		DOBIT(49, 7);
-		*p++ = p1;
-		*p++ = p2;
-		non_zero |= p1 | p2;
+		// Even plane's 8 rows, then odd plane's
+		__m128i	planes = _mm_packus_epi16(_mm_and_si128(v, _mm_set1_epi16(0xff)), _mm_srli_epi16(v, 8));
+
+		for (int h = 0; h < 2; h++)
+		{
+			__m128i	x  = h ? _mm_unpackhi_epi8(planes, planes) : _mm_unpacklo_epi8(planes, planes);
+			__m128i	lo = _mm_unpacklo_epi16(x, x);
+			__m128i	hi = _mm_unpackhi_epi16(x, x);
+			__m128i	row[4] = { _mm_unpacklo_epi32(lo, lo), _mm_unpackhi_epi32(lo, lo), _mm_unpacklo_epi32(hi, hi), _mm_unpackhi_epi32(hi, hi) };
+			__m128i	weight = _mm_set1_epi8((char) (1 << (k * 2 + h)));
+
+			for (int r = 0; r < 4; r++)
+				out[r] = _mm_or_si128(out[r], _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(row[r], bits), bits), weight));
+		}
 	}
 
-	return (non_zero ? TRUE : BLANK_TILE);
+	for (int r = 0; r < 4; r++)
+		_mm_storeu_si128((__m128i *) pCache + r, out[r]);
+
+	return (_mm_movemask_epi8(_mm_cmpeq_epi8(any, zero)) != 0xffff ? TRUE : BLANK_TILE);
 }
 
-#undef DOBIT
+#endif
 
-#define DOBIT(n, i) \
-	if ((pix = hrbit_odd[*(tp1 + (n))])) \
-		p1 |= pixbit[(i)][pix]; \
-	if ((pix = hrbit_odd[*(tp2 + (n))])) \
-		p2 |= pixbit[(i)][pix];
+#ifdef TILE_SSSE3
 
-static uint8 ConvertTile2h_odd (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+__attribute__((target("ssse3")))
+static uint8 ConvertPlanesSSSE3 (uint8 *pCache, const uint8 *tp, int pairs)
 {
-	register uint8	*tp1     = &Memory.VRAM[TileAddr], *tp2;
-	uint32			*p       = (uint32 *) pCache;
-	uint32			non_zero = 0;
-	uint8			line;
+	const __m128i	bits = _mm_set_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+	const __m128i	zero = _mm_setzero_si128();
+	__m128i			out[4] = { zero, zero, zero, zero };
+	__m128i			any = zero;
 
-	if (Tile == 0x3ff)
-		tp2 = tp1 - (0x3ff << 4);
-	else
-		tp2 = tp1 + (1 << 4);
+	// Picks the bytes of one plane in rows 2r and 2r + 1
+	#define SPREAD(r, h) \
+		_mm_setr_epi8(4 * (r) + (h), 4 * (r) + (h), 4 * (r) + (h), 4 * (r) + (h), 4 * (r) + (h), 4 * (r) + (h), 4 * (r) + (h), 4 * (r) + (h), \
+		              4 * (r) + (h) + 2, 4 * (r) + (h) + 2, 4 * (r) + (h) + 2, 4 * (r) + (h) + 2, 4 * (r) + (h) + 2, 4 * (r) + (h) + 2, 4 * (r) + (h) + 2, 4 * (r) + (h) + 2)
 
-	for (line = 8; line != 0; line--, tp1 += 2, tp2 += 2)
+	const __m128i	spread[2][4] =
 	{
-		uint32			p1 = 0;
-		uint32			p2 = 0;
-		register uint8	pix;
+		{ SPREAD(0, 0), SPREAD(1, 0), SPREAD(2, 0), SPREAD(3, 0) },
+		{ SPREAD(0, 1), SPREAD(1, 1), SPREAD(2, 1), SPREAD(3, 1) }
+	};
 
-		DOBIT( 0, 0);
-		DOBIT( 1, 1);
-		*p++ = p1;
-		*p++ = p2;
-		non_zero |= p1 | p2;
+	#undef SPREAD
+
+	for (int k = 0; k < pairs; k++, tp += 16)
+	{
+		__m128i	v = _mm_loadu_si128((const __m128i *) tp);
+		any = _mm_or_si128(any, v);
+
+		for (int h = 0; h < 2; h++)
+		{
+			__m128i	weight = _mm_set1_epi8((char) (1 << (k * 2 + h)));
+
+			for (int r = 0; r < 4; r++)
+			{
+				__m128i	row = _mm_shuffle_epi8(v, spread[h][r]);
+				out[r] = _mm_or_si128(out[r], _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(row, bits), bits), weight));
+			}
+		}
 	}
 
-	return (non_zero ? TRUE : BLANK_TILE);
+	for (int r = 0; r < 4; r++)
+		_mm_storeu_si128((__m128i *) pCache + r, out[r]);
+
+	return (_mm_movemask_epi8(_mm_cmpeq_epi8(any, zero)) != 0xffff ? TRUE : BLANK_TILE);
 }
 
-static uint8 ConvertTile4h_odd (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+#endif
+
+#ifdef TILE_NEON
+
+static uint8 ConvertPlanesNEON (uint8 *pCache, const uint8 *tp, int pairs)
 {
-	register uint8	*tp1     = &Memory.VRAM[TileAddr], *tp2;
-	uint32			*p       = (uint32 *) pCache;
-	uint32			non_zero = 0;
-	uint8			line;
+	static const uint8	bit_table[16]       = { 128, 64, 32, 16, 8, 4, 2, 1, 128, 64, 32, 16, 8, 4, 2, 1 };
+	static const uint8	spread_table[2][4][16] =
+	{
+		{
+			{ 0, 0, 0, 0, 0, 0, 0, 0,  2,  2,  2,  2,  2,  2,  2,  2 },
+			{ 4, 4, 4, 4, 4, 4, 4, 4,  6,  6,  6,  6,  6,  6,  6,  6 },
+			{ 8, 8, 8, 8, 8, 8, 8, 8, 10, 10, 10, 10, 10, 10, 10, 10 },
+			{12,12,12,12,12,12,12,12, 14, 14, 14, 14, 14, 14, 14, 14 }
+		},
+		{
+			{ 1, 1, 1, 1, 1, 1, 1, 1,  3,  3,  3,  3,  3,  3,  3,  3 },
+			{ 5, 5, 5, 5, 5, 5, 5, 5,  7,  7,  7,  7,  7,  7,  7,  7 },
+			{ 9, 9, 9, 9, 9, 9, 9, 9, 11, 11, 11, 11, 11, 11, 11, 11 },
+			{13,13,13,13,13,13,13,13, 15, 15, 15, 15, 15, 15, 15, 15 }
+		}
+	};
 
-	if (Tile == 0x3ff)
-		tp2 = tp1 - (0x3ff << 5);
-	else
-		tp2 = tp1 + (1 << 5);
+	const uint8x16_t	bits = vld1q_u8(bit_table);
+	uint8x16_t			out[4] = { vdupq_n_u8(0), vdupq_n_u8(0), vdupq_n_u8(0), vdupq_n_u8(0) };
+	uint8x16_t			any = vdupq_n_u8(0);
 
-	for (line = 8; line != 0; line--, tp1 += 2, tp2 += 2)
+	for (int k = 0; k < pairs; k++, tp += 16)
 	{
-		uint32			p1 = 0;
-		uint32			p2 = 0;
-		register uint8	pix;
+		uint8x16_t	v = vld1q_u8(tp);
+		any = vorrq_u8(any, v);
 
-		DOBIT( 0, 0);
-		DOBIT( 1, 1);
-		DOBIT(16, 2);
-		DOBIT(17, 3);
-		*p++ = p1;
-		*p++ = p2;
-		non_zero |= p1 | p2;
+		for (int h = 0; h < 2; h++)
+		{
+			uint8x16_t	weight = vdupq_n_u8(1 << (k * 2 + h));
+
+			for (int r = 0; r < 4; r++)
+			{
+				uint8x16_t	row = vqtbl1q_u8(v, vld1q_u8(spread_table[h][r]));
+				out[r] = vorrq_u8(out[r], vandq_u8(vtstq_u8(row, bits), weight));
+			}
+		}
 	}
 
-	return (non_zero ? TRUE : BLANK_TILE);
+	for (int r = 0; r < 4; r++)
+		vst1q_u8(pCache + r * 16, out[r]);
+
+	return (vmaxvq_u8(any) ? TRUE : BLANK_TILE);
 }
 
-#undef DOBIT
+#endif
 
-#define DOBIT(n, i) \
-	if ((pix = hrbit_even[*(tp1 + (n))])) \
-		p1 |= pixbit[(i)][pix]; \
-	if ((pix = hrbit_even[*(tp2 + (n))])) \
-		p2 |= pixbit[(i)][pix];
+static uint8 ConvertTile2 (uint8 *pCache, uint32 TileAddr, uint32)
+{
+	return (ConvertPlanes(pCache, &GFX.VRAM[TileAddr], 1));
+}
 
-static uint8 ConvertTile2h_even (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+static uint8 ConvertTile4 (uint8 *pCache, uint32 TileAddr, uint32)
 {
-	register uint8	*tp1     = &Memory.VRAM[TileAddr], *tp2;
-	uint32			*p       = (uint32 *) pCache;
-	uint32			non_zero = 0;
-	uint8			line;
+	return (ConvertPlanes(pCache, &GFX.VRAM[TileAddr], 2));
+}
 
-	if (Tile == 0x3ff)
-		tp2 = tp1 - (0x3ff << 4);
-	else
-		tp2 = tp1 + (1 << 4);
+static uint8 ConvertTile8 (uint8 *pCache, uint32 TileAddr, uint32)
+{
+	return (ConvertPlanes(pCache, &GFX.VRAM[TileAddr], 4));
+}
 
-	for (line = 8; line != 0; line--, tp1 += 2, tp2 += 2)
-	{
-		uint32			p1 = 0;
-		uint32			p2 = 0;
-		register uint8	pix;
+// Left half from this tile, right half from the next. The next tile wraps
+// around the end of VRAM, as the tile cache invalidation in ppu.h expects.
 
-		DOBIT( 0, 0);
-		DOBIT( 1, 1);
-		*p++ = p1;
-		*p++ = p2;
-		non_zero |= p1 | p2;
-	}
+#define CONVERT_HIRES(pairs, table) \
+	uint8	*tp1 = &GFX.VRAM[TileAddr], *tp2; \
+	uint8	planes[(pairs) * 16]; \
+	\
+	if (Tile == 0x3ff) \
+		tp2 = &GFX.VRAM[(TileAddr - (0x3ff << ((pairs) + 3))) & 0xffff]; \
+	else \
+		tp2 = &GFX.VRAM[(TileAddr + (1 << ((pairs) + 3))) & 0xffff]; \
+	\
+	for (int i = 0; i < (pairs) * 16; i++) \
+		planes[i] = (table[tp1[i]] << 4) | table[tp2[i]]; \
+	\
+	return (ConvertPlanes(pCache, planes, (pairs)))
 
-	return (non_zero ? TRUE : BLANK_TILE);
+static uint8 ConvertTile2h_odd (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+{
+	CONVERT_HIRES(1, hrbit_odd);
+}
+
+static uint8 ConvertTile4h_odd (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+{
+	CONVERT_HIRES(2, hrbit_odd);
+}
+
+static uint8 ConvertTile2h_even (uint8 *pCache, uint32 TileAddr, uint32 Tile)
+{
+	CONVERT_HIRES(1, hrbit_even);
 }
 
 static uint8 ConvertTile4h_even (uint8 *pCache, uint32 TileAddr, uint32 Tile)
 {
-	register uint8	*tp1     = &Memory.VRAM[TileAddr], *tp2;
-	uint32			*p       = (uint32 *) pCache;
-	uint32			non_zero = 0;
-	uint8			line;
+	CONVERT_HIRES(2, hrbit_even);
+}
 
-	if (Tile == 0x3ff)
-		tp2 = tp1 - (0x3ff << 5);
-	else
-		tp2 = tp1 + (1 << 5);
+#undef CONVERT_HIRES
 
-	for (line = 8; line != 0; line--, tp1 += 2, tp2 += 2)
-	{
-		uint32			p1 = 0;
-		uint32			p2 = 0;
-		register uint8	pix;
+#ifdef USE_THREADS
+// Render threads share the tile caches (see gfx.cpp). The first thread to
+// find a tile unconverted claims its flag and publishes the result with a
+// release store once the pixels are written; any other thread waits for it,
+// so a flag read as set is always ordered after its pixels.
 
-		DOBIT( 0, 0);
-		DOBIT( 1, 1);
-		DOBIT(16, 2);
-		DOBIT(17, 3);
-		*p++ = p1;
-		*p++ = p2;
-		non_zero |= p1 | p2;
+#define TILE_CONVERTING	0xff
+
+static uint8 ConvertSharedTile (uint8 *flag, uint8 (*convert) (uint8 *, uint32, uint32), uint8 *pCache, uint32 TileAddr, uint32 Tile)
+{
+	uint8	f = 0;
+
+	if (__atomic_compare_exchange_n(flag, &f, TILE_CONVERTING, false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+	{
+		f = convert(pCache, TileAddr, Tile);
+		__atomic_store_n(flag, f, __ATOMIC_RELEASE);
+		return (f);
 	}
 
-	return (non_zero ? TRUE : BLANK_TILE);
+	while (f == TILE_CONVERTING)
+		f = __atomic_load_n(flag, __ATOMIC_ACQUIRE);
+
+	return (f);
 }
 
-#undef DOBIT
+#define TILE_FLAG(flag)				__atomic_load_n(&(flag), __ATOMIC_ACQUIRE)
+#define CONVERT_TILE(flag, convert)	ConvertSharedTile(&(flag), convert, pCache, TileAddr, Tile & 0x3ff)
+#else
+#define TILE_FLAG(flag)				(flag)
+#define CONVERT_TILE(flag, convert)	((flag) = convert(pCache, TileAddr, Tile & 0x3ff))
+#endif
 
 // First-level include: Get all the renderers.
 
@@ -489,6 +579,7 @@ void S9xSelectTileRenderers (int BGMode, bool8 sub, bool8 obj)
 	void	(**DM7BG1)	(uint32, uint32, int);
 	void	(**DM7BG2)	(uint32, uint32, int);
 	bool8	M7M1, M7M2;
+	int		pf = PIXEL_FORMAT_INDEX;
 
 	M7M1 = PPU.BGMosaic[0] && PPU.Mosaic > 1;
 	M7M2 = PPU.BGMosaic[1] && PPU.Mosaic > 1;
@@ -498,34 +589,34 @@ void S9xSelectTileRenderers (int BGMode, bool8 sub, bool8 obj)
 
 	if (!IPPU.DoubleWidthPixels)	// normal width
 	{
-		DT     = Renderers_DrawTile16Normal1x1;
-		DCT    = Renderers_DrawClippedTile16Normal1x1;
-		DMP    = Renderers_DrawMosaicPixel16Normal1x1;
-		DB     = Renderers_DrawBackdrop16Normal1x1;
-		DM7BG1 = M7M1 ? Renderers_DrawMode7MosaicBG1Normal1x1 : Renderers_DrawMode7BG1Normal1x1;
-		DM7BG2 = M7M2 ? Renderers_DrawMode7MosaicBG2Normal1x1 : Renderers_DrawMode7BG2Normal1x1;
+		DT     = Renderers_DrawTile16Normal1x1[pf];
+		DCT    = Renderers_DrawClippedTile16Normal1x1[pf];
+		DMP    = Renderers_DrawMosaicPixel16Normal1x1[pf];
+		DB     = Renderers_DrawBackdrop16Normal1x1[pf];
+		DM7BG1 = M7M1 ? Renderers_DrawMode7MosaicBG1Normal1x1[pf] : Renderers_DrawMode7BG1Normal1x1[pf];
+		DM7BG2 = M7M2 ? Renderers_DrawMode7MosaicBG2Normal1x1[pf] : Renderers_DrawMode7BG2Normal1x1[pf];
 		GFX.LinesPerTile = 8;
 	}
 	else if(hires)					// hires double width
 	{
 		if (interlace)
 		{
-			DT     = Renderers_DrawTile16HiresInterlace;
-			DCT    = Renderers_DrawClippedTile16HiresInterlace;
-			DMP    = Renderers_DrawMosaicPixel16HiresInterlace;
-			DB     = Renderers_DrawBackdrop16Hires;
-			DM7BG1 = M7M1 ? Renderers_DrawMode7MosaicBG1Hires : Renderers_DrawMode7BG1Hires;
-			DM7BG2 = M7M2 ? Renderers_DrawMode7MosaicBG2Hires : Renderers_DrawMode7BG2Hires;
+			DT     = Renderers_DrawTile16HiresInterlace[pf];
+			DCT    = Renderers_DrawClippedTile16HiresInterlace[pf];
+			DMP    = Renderers_DrawMosaicPixel16HiresInterlace[pf];
+			DB     = Renderers_DrawBackdrop16Hires[pf];
+			DM7BG1 = M7M1 ? Renderers_DrawMode7MosaicBG1Hires[pf] : Renderers_DrawMode7BG1Hires[pf];
+			DM7BG2 = M7M2 ? Renderers_DrawMode7MosaicBG2Hires[pf] : Renderers_DrawMode7BG2Hires[pf];
 			GFX.LinesPerTile = 4;
 		}
 		else
 		{
-			DT     = Renderers_DrawTile16Hires;
-			DCT    = Renderers_DrawClippedTile16Hires;
-			DMP    = Renderers_DrawMosaicPixel16Hires;
-			DB     = Renderers_DrawBackdrop16Hires;
-			DM7BG1 = M7M1 ? Renderers_DrawMode7MosaicBG1Hires : Renderers_DrawMode7BG1Hires;
-			DM7BG2 = M7M2 ? Renderers_DrawMode7MosaicBG2Hires : Renderers_DrawMode7BG2Hires;
+			DT     = Renderers_DrawTile16Hires[pf];
+			DCT    = Renderers_DrawClippedTile16Hires[pf];
+			DMP    = Renderers_DrawMosaicPixel16Hires[pf];
+			DB     = Renderers_DrawBackdrop16Hires[pf];
+			DM7BG1 = M7M1 ? Renderers_DrawMode7MosaicBG1Hires[pf] : Renderers_DrawMode7BG1Hires[pf];
+			DM7BG2 = M7M2 ? Renderers_DrawMode7MosaicBG2Hires[pf] : Renderers_DrawMode7BG2Hires[pf];
 			GFX.LinesPerTile = 8;
 		}
 	}
@@ -533,22 +624,22 @@ void S9xSelectTileRenderers (int BGMode, bool8 sub, bool8 obj)
 	{
 		if (interlace)
 		{
-			DT     = Renderers_DrawTile16Interlace;
-			DCT    = Renderers_DrawClippedTile16Interlace;
-			DMP    = Renderers_DrawMosaicPixel16Interlace;
-			DB     = Renderers_DrawBackdrop16Normal2x1;
-			DM7BG1 = M7M1 ? Renderers_DrawMode7MosaicBG1Normal2x1 : Renderers_DrawMode7BG1Normal2x1;
-			DM7BG2 = M7M2 ? Renderers_DrawMode7MosaicBG2Normal2x1 : Renderers_DrawMode7BG2Normal2x1;
+			DT     = Renderers_DrawTile16Interlace[pf];
+			DCT    = Renderers_DrawClippedTile16Interlace[pf];
+			DMP    = Renderers_DrawMosaicPixel16Interlace[pf];
+			DB     = Renderers_DrawBackdrop16Normal2x1[pf];
+			DM7BG1 = M7M1 ? Renderers_DrawMode7MosaicBG1Normal2x1[pf] : Renderers_DrawMode7BG1Normal2x1[pf];
+			DM7BG2 = M7M2 ? Renderers_DrawMode7MosaicBG2Normal2x1[pf] : Renderers_DrawMode7BG2Normal2x1[pf];
 			GFX.LinesPerTile = 4;
 		}
 		else
 		{
-			DT     = Renderers_DrawTile16Normal2x1;
-			DCT    = Renderers_DrawClippedTile16Normal2x1;
-			DMP    = Renderers_DrawMosaicPixel16Normal2x1;
-			DB     = Renderers_DrawBackdrop16Normal2x1;
-			DM7BG1 = M7M1 ? Renderers_DrawMode7MosaicBG1Normal2x1 : Renderers_DrawMode7BG1Normal2x1;
-			DM7BG2 = M7M2 ? Renderers_DrawMode7MosaicBG2Normal2x1 : Renderers_DrawMode7BG2Normal2x1;
+			DT     = Renderers_DrawTile16Normal2x1[pf];
+			DCT    = Renderers_DrawClippedTile16Normal2x1[pf];
+			DMP    = Renderers_DrawMosaicPixel16Normal2x1[pf];
+			DB     = Renderers_DrawBackdrop16Normal2x1[pf];
+			DM7BG1 = M7M1 ? Renderers_DrawMode7MosaicBG1Normal2x1[pf] : Renderers_DrawMode7BG1Normal2x1[pf];
+			DM7BG2 = M7M2 ? Renderers_DrawMode7MosaicBG2Normal2x1[pf] : Renderers_DrawMode7BG2Normal2x1[pf];
 			GFX.LinesPerTile = 8;
 		}
 	}
@@ -566,11 +657,11 @@ void S9xSelectTileRenderers (int BGMode, bool8 sub, bool8 obj)
 		i = 0;
 	else
 	{
-		i = (Memory.FillRAM[0x2131] & 0x80) ? 4 : 1;
-		if (Memory.FillRAM[0x2131] & 0x40)
+		i = (GFX.FillRAM[0x2131] & 0x80) ? 4 : 1;
+		if (GFX.FillRAM[0x2131] & 0x40)
 		{
 			i++;
-			if (Memory.FillRAM[0x2130] & 2)
+			if (GFX.FillRAM[0x2130] & 2)
 				i++;
 		}
 	}
@@ -594,7 +685,7 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 			BG.TileShift        = 6;
 			BG.PaletteShift     = 0;
 			BG.PaletteMask      = 0;
-			BG.DirectColourMode = Memory.FillRAM[0x2130] & 1;
+			BG.DirectColourMode = GFX.FillRAM[0x2130] & 1;
 
 			break;
 
@@ -687,18 +778,18 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 	if (Tile & H_FLIP) \
 	{ \
 		pCache = &BG.BufferFlip[TileNumber << 6]; \
-		if (!BG.BufferedFlip[TileNumber]) \
-			BG.BufferedFlip[TileNumber] = BG.ConvertTileFlip(pCache, TileAddr, Tile & 0x3ff); \
+		if (!TILE_FLAG(BG.BufferedFlip[TileNumber])) \
+			CONVERT_TILE(BG.BufferedFlip[TileNumber], BG.ConvertTileFlip); \
 	} \
 	else \
 	{ \
 		pCache = &BG.Buffer[TileNumber << 6]; \
-		if (!BG.Buffered[TileNumber]) \
-			BG.Buffered[TileNumber] = BG.ConvertTile(pCache, TileAddr, Tile & 0x3ff); \
+		if (!TILE_FLAG(BG.Buffered[TileNumber])) \
+			CONVERT_TILE(BG.Buffered[TileNumber], BG.ConvertTile); \
 	}
 
 #define IS_BLANK_TILE() \
-	(BG.Buffered[TileNumber] == BLANK_TILE)
+	(TILE_FLAG(BG.Buffered[TileNumber]) == BLANK_TILE)
 
 #define SELECT_PALETTE() \
 	if (BG.DirectColourMode) \
@@ -714,14 +805,238 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 #define NOMATH(Op, Main, Sub, SD) \
 	(Main)
 
+// FMT is the pixel format the renderer is instantiated for
+
 #define REGMATH(Op, Main, Sub, SD) \
-	(COLOR_##Op((Main), ((SD) & 0x20) ? (Sub) : GFX.FixedColour))
+	(ColourMath<FMT>::Op((Main), ((SD) & 0x20) ? (Sub) : GFX.FixedColour))
 
 #define MATHF1_2(Op, Main, Sub, SD) \
-	(GFX.ClipColors ? (COLOR_##Op((Main), GFX.FixedColour)) : (COLOR_##Op##1_2((Main), GFX.FixedColour)))
+	(GFX.ClipColors ? (ColourMath<FMT>::Op((Main), GFX.FixedColour)) : (ColourMath<FMT>::Op##1_2((Main), GFX.FixedColour)))
 
 #define MATHS1_2(Op, Main, Sub, SD) \
-	(GFX.ClipColors ? REGMATH(Op, Main, Sub, SD) : (((SD) & 0x20) ? COLOR_##Op##1_2((Main), (Sub)) : COLOR_##Op((Main), GFX.FixedColour)))
+	(GFX.ClipColors ? REGMATH(Op, Main, Sub, SD) : (((SD) & 0x20) ? ColourMath<FMT>::Op##1_2((Main), (Sub)) : ColourMath<FMT>::Op((Main), GFX.FixedColour)))
+
+#ifdef TILE_VECTOR_MATH
+
+#if PIXEL_BITS == 16
+
+// The colour math of gfx.h on 8 pixels at once, giving exactly what the X2 and ZERO tables give
+
+template <int FMT>
+struct VColourMath
+{
+	typedef PixelFormat<FMT>	P;
+
+	static inline __m128i Low (void)
+	{
+		return (_mm_set1_epi16((int16) P::LowBits));
+	}
+
+	// The lanes where the top bit of colour Field is set, masked with Keep
+	static inline __m128i TopSet (__m128i v, uint32 Field, uint32 Keep)
+	{
+		__m128i	top = _mm_set1_epi16((int16) (Field & ~(Field >> 1)));
+
+		return (_mm_and_si128(_mm_cmpeq_epi16(_mm_and_si128(v, top), top), _mm_set1_epi16((int16) Keep)));
+	}
+
+	static inline __m128i SubField (__m128i C1, __m128i C2, uint32 Field)
+	{
+		__m128i	f = _mm_set1_epi16((int16) Field);
+
+		return (_mm_subs_epu16(_mm_and_si128(C1, f), _mm_and_si128(C2, f)));
+	}
+
+	static inline __m128i Add1_2 (__m128i C1, __m128i C2)
+	{
+		__m128i	a = _mm_andnot_si128(Low(), C1);
+		__m128i	b = _mm_andnot_si128(Low(), C2);
+
+		// (a + b) >> 1 without losing the carry out of the top colour
+		__m128i	h = _mm_add_epi16(_mm_and_si128(a, b), _mm_srli_epi16(_mm_xor_si128(a, b), 1));
+
+		return (_mm_add_epi16(h, _mm_and_si128(_mm_and_si128(C1, C2), Low())));
+	}
+
+	static inline __m128i Add (__m128i C1, __m128i C2)
+	{
+		__m128i	h    = Add1_2(C1, C2);
+		__m128i	high = _mm_set1_epi16((int16) ((P::FirstColor | P::SecondColor | P::ThirdColor) & P::RemoveLowBits));
+
+		// X2: double each colour, or saturate it if its top bit is set
+		__m128i	sat  = _mm_or_si128(_mm_or_si128(TopSet(h, P::FirstColor, P::FirstColor), TopSet(h, P::SecondColor, P::SecondColor)), TopSet(h, P::ThirdColor, P::ThirdColor));
+
+		return (_mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_slli_epi16(h, 1), high), sat), _mm_and_si128(_mm_xor_si128(C1, C2), Low())));
+	}
+
+	static inline __m128i Sub1_2 (__m128i C1, __m128i C2)
+	{
+		__m128i	a = _mm_or_si128(C1, _mm_set1_epi16((int16) P::HiBitsX2));
+		__m128i	b = _mm_andnot_si128(Low(), C2);
+		__m128i	d = _mm_srli_epi16(_mm_sub_epi16(a, b), 1);
+
+		// Put back the 17th bit of the difference, set when it did not borrow
+		if (P::HiBitsX2 >> 16)
+			d = _mm_or_si128(d, _mm_and_si128(_mm_cmpeq_epi16(_mm_subs_epu16(b, a), _mm_setzero_si128()), _mm_set1_epi16((int16) 0x8000)));
+
+		// ZERO: keep the colours whose top bit is set, less that bit
+		const uint32	top1 = P::FirstColor  & ~(P::FirstColor  >> 1);
+		const uint32	top2 = P::SecondColor & ~(P::SecondColor >> 1);
+		const uint32	top3 = P::ThirdColor  & ~(P::ThirdColor  >> 1);
+		__m128i			keep = _mm_or_si128(_mm_or_si128(TopSet(d, P::FirstColor, P::FirstColor & ~top1), TopSet(d, P::SecondColor, P::SecondColor & ~top2)), TopSet(d, P::ThirdColor, P::ThirdColor & ~top3));
+
+		return (_mm_and_si128(d, keep));
+	}
+
+	static inline __m128i Sub (__m128i C1, __m128i C2)
+	{
+		return (_mm_or_si128(_mm_or_si128(SubField(C1, C2, P::FirstColor), SubField(C1, C2, P::SecondColor)), SubField(C1, C2, P::ThirdColor)));
+	}
+};
+
+#define VSUBMATH(SD) \
+	_mm_cmpeq_epi16(_mm_and_si128((SD), _mm_set1_epi16(0x20)), _mm_set1_epi16(0x20))
+
+#define VFIXED \
+	_mm_set1_epi16((int16) GFX.FixedColour)
+
+#else
+
+// The colour math of gfx.h on 4 XRGB8888 pixels at once, where every colour is a byte of its own
+
+template <int FMT>
+struct VColourMath
+{
+	static inline __m128i Add1_2 (__m128i C1, __m128i C2)
+	{
+		// the average rounded down
+		return (_mm_sub_epi8(_mm_avg_epu8(C1, C2), _mm_and_si128(_mm_xor_si128(C1, C2), _mm_set1_epi8(1))));
+	}
+
+	static inline __m128i Add (__m128i C1, __m128i C2)
+	{
+		return (_mm_adds_epu8(C1, C2));
+	}
+
+	static inline __m128i Sub1_2 (__m128i C1, __m128i C2)
+	{
+		__m128i	d = _mm_subs_epu8(C1, _mm_andnot_si128(_mm_set1_epi8(1), C2));
+
+		return (_mm_and_si128(_mm_srli_epi16(d, 1), _mm_set1_epi8(0x7f)));
+	}
+
+	static inline __m128i Sub (__m128i C1, __m128i C2)
+	{
+		return (_mm_subs_epu8(C1, C2));
+	}
+};
+
+#define VSUBMATH(SD) \
+	_mm_cmpeq_epi32(_mm_and_si128((SD), _mm_set1_epi32(0x20)), _mm_set1_epi32(0x20))
+
+#define VFIXED \
+	_mm_set1_epi32(GFX.FixedColour)
+
+#endif
+
+static inline __m128i VSELECT (__m128i mask, __m128i a, __m128i b)
+{
+	return (_mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)));
+}
+
+#define VNOMATH(Op, Main, Sub, SD) \
+	(Main)
+
+#define VREGMATH(Op, Main, Sub, SD) \
+	(VColourMath<FMT>::Op((Main), VSELECT(VSUBMATH(SD), (Sub), VFIXED)))
+
+#define VMATHF1_2(Op, Main, Sub, SD) \
+	(GFX.ClipColors ? VColourMath<FMT>::Op((Main), VFIXED) : VColourMath<FMT>::Op##1_2((Main), VFIXED))
+
+#define VMATHS1_2(Op, Main, Sub, SD) \
+	(GFX.ClipColors ? VREGMATH(Op, Main, Sub, SD) : VSELECT(VSUBMATH(SD), VColourMath<FMT>::Op##1_2((Main), (Sub)), VColourMath<FMT>::Op((Main), VFIXED)))
+
+// One row of an unclipped tile: depth test, sub screen fetch, math and masked store for all 8 pixels together.
+// A to H are the offsets in bp of the pixels to draw, left to right.
+
+#if PIXEL_BITS == 16
+
+#define DRAW_ROW_VECTOR(A, B, C, D, E, F, G, H) \
+	{ \
+		__m128i	zero = _mm_setzero_si128(); \
+		__m128i	pix  = _mm_setr_epi16(bp[A], bp[B], bp[C], bp[D], bp[E], bp[F], bp[G], bp[H]); \
+		__m128i	db   = _mm_loadl_epi64((__m128i *) (GFX.DB + Offset)); \
+		__m128i	draw = _mm_andnot_si128(_mm_cmpeq_epi16(pix, zero), _mm_cmpgt_epi16(_mm_set1_epi16(Z1), _mm_unpacklo_epi8(db, zero))); \
+		\
+		if (_mm_movemask_epi8(draw)) \
+		{ \
+			__m128i	*s   = (__m128i *) (GFX.S + Offset); \
+			__m128i	main = _mm_setr_epi16(GFX.ScreenColors[bp[A]], GFX.ScreenColors[bp[B]], GFX.ScreenColors[bp[C]], GFX.ScreenColors[bp[D]], \
+			                              GFX.ScreenColors[bp[E]], GFX.ScreenColors[bp[F]], GFX.ScreenColors[bp[G]], GFX.ScreenColors[bp[H]]); \
+			\
+			_mm_storeu_si128(s, VSELECT(draw, VMATH(main, _mm_loadu_si128((__m128i *) (GFX.SubScreen + Offset)), \
+			                                        _mm_unpacklo_epi8(_mm_loadl_epi64((__m128i *) (GFX.SubZBuffer + Offset)), zero)), _mm_loadu_si128(s))); \
+			_mm_storel_epi64((__m128i *) (GFX.DB + Offset), VSELECT(_mm_packs_epi16(draw, draw), _mm_set1_epi8(Z2), db)); \
+		} \
+	}
+
+#else
+
+// The depth test is still done on all 8, the colours 4 at a time
+
+#define DRAW_ROW_VECTOR_HALF(N, unpack, A, B, C, D) \
+	{ \
+		__m128i	*s = (__m128i *) (GFX.S + Offset) + N; \
+		__m128i	main = _mm_setr_epi32(GFX.ScreenColors[bp[A]], GFX.ScreenColors[bp[B]], GFX.ScreenColors[bp[C]], GFX.ScreenColors[bp[D]]); \
+		\
+		_mm_storeu_si128(s, VSELECT(unpack(draw, draw), VMATH(main, _mm_loadu_si128((__m128i *) (GFX.SubScreen + Offset) + N), \
+		                                                      unpack(_mm_unpacklo_epi8(_mm_loadl_epi64((__m128i *) (GFX.SubZBuffer + Offset)), zero), zero)), _mm_loadu_si128(s))); \
+	}
+
+#define DRAW_ROW_VECTOR(A, B, C, D, E, F, G, H) \
+	{ \
+		__m128i	zero = _mm_setzero_si128(); \
+		__m128i	pix  = _mm_setr_epi16(bp[A], bp[B], bp[C], bp[D], bp[E], bp[F], bp[G], bp[H]); \
+		__m128i	db   = _mm_loadl_epi64((__m128i *) (GFX.DB + Offset)); \
+		__m128i	draw = _mm_andnot_si128(_mm_cmpeq_epi16(pix, zero), _mm_cmpgt_epi16(_mm_set1_epi16(Z1), _mm_unpacklo_epi8(db, zero))); \
+		\
+		if (_mm_movemask_epi8(draw)) \
+		{ \
+			DRAW_ROW_VECTOR_HALF(0, _mm_unpacklo_epi16, A, B, C, D); \
+			DRAW_ROW_VECTOR_HALF(1, _mm_unpackhi_epi16, E, F, G, H); \
+			_mm_storel_epi64((__m128i *) (GFX.DB + Offset), VSELECT(_mm_packs_epi16(draw, draw), _mm_set1_epi8(Z2), db)); \
+		} \
+	}
+
+#endif
+
+#endif
+
+#define DRAW_ROW_PIXELS(A, B, C, D, E, F, G, H) \
+	DRAW_PIXEL(0, Pix = bp[A]); \
+	DRAW_PIXEL(1, Pix = bp[B]); \
+	DRAW_PIXEL(2, Pix = bp[C]); \
+	DRAW_PIXEL(3, Pix = bp[D]); \
+	DRAW_PIXEL(4, Pix = bp[E]); \
+	DRAW_PIXEL(5, Pix = bp[F]); \
+	DRAW_PIXEL(6, Pix = bp[G]); \
+	DRAW_PIXEL(7, Pix = bp[H]);
+
+// VECTOR_ROW is set by the plotters that draw 8 plain contiguous pixels per row,
+// VECTOR_MATH by the renderers whose math the vector code can do
+
+#ifdef TILE_VECTOR_MATH
+#define DRAW_ROW(A, B, C, D, E, F, G, H) \
+	if (VECTOR_ROW && VECTOR_MATH) \
+		DRAW_ROW_VECTOR(A, B, C, D, E, F, G, H) \
+	else \
+	{ \
+		DRAW_ROW_PIXELS(A, B, C, D, E, F, G, H) \
+	}
+#else
+#define DRAW_ROW(A, B, C, D, E, F, G, H) \
+	DRAW_ROW_PIXELS(A, B, C, D, E, F, G, H)
+#endif
 
 // Basic routine to render an unclipped tile.
 // Input parameters:
@@ -752,14 +1067,7 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 		bp = pCache + BPSTART; \
 		for (l = LineCount; l > 0; l--, bp += 8 * PITCH, Offset += GFX.PPL) \
 		{ \
-			DRAW_PIXEL(0, Pix = bp[0]); \
-			DRAW_PIXEL(1, Pix = bp[1]); \
-			DRAW_PIXEL(2, Pix = bp[2]); \
-			DRAW_PIXEL(3, Pix = bp[3]); \
-			DRAW_PIXEL(4, Pix = bp[4]); \
-			DRAW_PIXEL(5, Pix = bp[5]); \
-			DRAW_PIXEL(6, Pix = bp[6]); \
-			DRAW_PIXEL(7, Pix = bp[7]); \
+			DRAW_ROW(0, 1, 2, 3, 4, 5, 6, 7); \
 		} \
 	} \
 	else \
@@ -768,14 +1076,7 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 		bp = pCache + BPSTART; \
 		for (l = LineCount; l > 0; l--, bp += 8 * PITCH, Offset += GFX.PPL) \
 		{ \
-			DRAW_PIXEL(0, Pix = bp[7]); \
-			DRAW_PIXEL(1, Pix = bp[6]); \
-			DRAW_PIXEL(2, Pix = bp[5]); \
-			DRAW_PIXEL(3, Pix = bp[4]); \
-			DRAW_PIXEL(4, Pix = bp[3]); \
-			DRAW_PIXEL(5, Pix = bp[2]); \
-			DRAW_PIXEL(6, Pix = bp[1]); \
-			DRAW_PIXEL(7, Pix = bp[0]); \
+			DRAW_ROW(7, 6, 5, 4, 3, 2, 1, 0); \
 		} \
 	} \
 	else \
@@ -784,14 +1085,7 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 		bp = pCache + 56 - BPSTART; \
 		for (l = LineCount; l > 0; l--, bp -= 8 * PITCH, Offset += GFX.PPL) \
 		{ \
-			DRAW_PIXEL(0, Pix = bp[0]); \
-			DRAW_PIXEL(1, Pix = bp[1]); \
-			DRAW_PIXEL(2, Pix = bp[2]); \
-			DRAW_PIXEL(3, Pix = bp[3]); \
-			DRAW_PIXEL(4, Pix = bp[4]); \
-			DRAW_PIXEL(5, Pix = bp[5]); \
-			DRAW_PIXEL(6, Pix = bp[6]); \
-			DRAW_PIXEL(7, Pix = bp[7]); \
+			DRAW_ROW(0, 1, 2, 3, 4, 5, 6, 7); \
 		} \
 	} \
 	else \
@@ -799,14 +1093,7 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 		bp = pCache + 56 - BPSTART; \
 		for (l = LineCount; l > 0; l--, bp -= 8 * PITCH, Offset += GFX.PPL) \
 		{ \
-			DRAW_PIXEL(0, Pix = bp[7]); \
-			DRAW_PIXEL(1, Pix = bp[6]); \
-			DRAW_PIXEL(2, Pix = bp[5]); \
-			DRAW_PIXEL(3, Pix = bp[4]); \
-			DRAW_PIXEL(4, Pix = bp[3]); \
-			DRAW_PIXEL(5, Pix = bp[2]); \
-			DRAW_PIXEL(6, Pix = bp[1]); \
-			DRAW_PIXEL(7, Pix = bp[0]); \
+			DRAW_ROW(7, 6, 5, 4, 3, 2, 1, 0); \
 		} \
 	}
 
@@ -1013,6 +1300,90 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 #undef Z2
 #undef NO_INTERLACE
 
+// Fetch Count Mode 7 pixels along a line, with the coordinates wrapping at 1024.
+// X and Y are the starting coordinates << 8, XStep and YStep the per-pixel steps.
+// The coordinates of four pixels are worked out at once, then their pixels are gathered.
+
+static void FetchMode7Line (uint8 *Pixels, const uint8 *VRAM, int Count, int X, int Y, int XStep, int YStep)
+{
+	int	x = 0;
+
+#if defined(TILE_SSE2)
+	__m128i	vx    = _mm_setr_epi32(X, X + XStep, X + 2 * XStep, X + 3 * XStep);
+	__m128i	vy    = _mm_setr_epi32(Y, Y + YStep, Y + 2 * YStep, Y + 3 * YStep);
+	__m128i	xstep = _mm_set1_epi32(4 * XStep);
+	__m128i	ystep = _mm_set1_epi32(4 * YStep);
+	__m128i	wrap  = _mm_set1_epi32(0x3ff);
+	__m128i	seven = _mm_set1_epi32(7);
+	__m128i	even  = _mm_set1_epi32(~1);
+
+	for (; x + 4 <= Count; x += 4)
+	{
+		__m128i	px = _mm_and_si128(_mm_srai_epi32(vx, 8), wrap);
+		__m128i	py = _mm_and_si128(_mm_srai_epi32(vy, 8), wrap);
+
+		// Tile map address, and the offset of the pixel within its tile
+		__m128i	map  = _mm_add_epi32(_mm_slli_epi32(_mm_andnot_si128(seven, py), 5), _mm_and_si128(_mm_srli_epi32(px, 2), even));
+		__m128i	fine = _mm_add_epi32(_mm_slli_epi32(_mm_and_si128(py, seven), 4), _mm_slli_epi32(_mm_and_si128(px, seven), 1));
+
+		uint32	m[4], f[4];
+		_mm_storeu_si128((__m128i *) m, map);
+		_mm_storeu_si128((__m128i *) f, fine);
+
+		Pixels[x + 0] = VRAM[1 + (VRAM[m[0]] << 7) + f[0]];
+		Pixels[x + 1] = VRAM[1 + (VRAM[m[1]] << 7) + f[1]];
+		Pixels[x + 2] = VRAM[1 + (VRAM[m[2]] << 7) + f[2]];
+		Pixels[x + 3] = VRAM[1 + (VRAM[m[3]] << 7) + f[3]];
+
+		vx = _mm_add_epi32(vx, xstep);
+		vy = _mm_add_epi32(vy, ystep);
+	}
+
+	X += x * XStep;
+	Y += x * YStep;
+#elif defined(TILE_NEON)
+	const int32	lanes[4] = { 0, 1, 2, 3 };
+	int32x4_t	vx    = vmlaq_n_s32(vdupq_n_s32(X), vld1q_s32(lanes), XStep);
+	int32x4_t	vy    = vmlaq_n_s32(vdupq_n_s32(Y), vld1q_s32(lanes), YStep);
+	int32x4_t	xstep = vdupq_n_s32(4 * XStep);
+	int32x4_t	ystep = vdupq_n_s32(4 * YStep);
+	uint32x4_t	wrap  = vdupq_n_u32(0x3ff);
+	uint32x4_t	seven = vdupq_n_u32(7);
+
+	for (; x + 4 <= Count; x += 4)
+	{
+		uint32x4_t	px = vandq_u32(vreinterpretq_u32_s32(vshrq_n_s32(vx, 8)), wrap);
+		uint32x4_t	py = vandq_u32(vreinterpretq_u32_s32(vshrq_n_s32(vy, 8)), wrap);
+
+		uint32x4_t	map  = vaddq_u32(vshlq_n_u32(vbicq_u32(py, seven), 5), vbicq_u32(vshrq_n_u32(px, 2), vdupq_n_u32(1)));
+		uint32x4_t	fine = vaddq_u32(vshlq_n_u32(vandq_u32(py, seven), 4), vshlq_n_u32(vandq_u32(px, seven), 1));
+
+		uint32	m[4], f[4];
+		vst1q_u32(m, map);
+		vst1q_u32(f, fine);
+
+		Pixels[x + 0] = VRAM[1 + (VRAM[m[0]] << 7) + f[0]];
+		Pixels[x + 1] = VRAM[1 + (VRAM[m[1]] << 7) + f[1]];
+		Pixels[x + 2] = VRAM[1 + (VRAM[m[2]] << 7) + f[2]];
+		Pixels[x + 3] = VRAM[1 + (VRAM[m[3]] << 7) + f[3]];
+
+		vx = vaddq_s32(vx, xstep);
+		vy = vaddq_s32(vy, ystep);
+	}
+
+	X += x * XStep;
+	Y += x * YStep;
+#endif
+
+	for (; x < Count; x++, X += XStep, Y += YStep)
+	{
+		int	px = (X >> 8) & 0x3ff;
+		int	py = (Y >> 8) & 0x3ff;
+
+		Pixels[x] = VRAM[1 + (VRAM[((py & ~7) << 5) + ((px >> 2) & ~1)] << 7) + ((py & 7) << 4) + ((px & 7) << 1)];
+	}
+}
+
 // Basic routine to render a chunk of a Mode 7 BG.
 // Mode 7 has no interlace, so BPSTART and PITCH are unused.
 // We get some new parameters, so we can use the same DRAW_TILE to do BG1 or BG2:
@@ -1023,17 +1394,15 @@ void S9xSelectTileConverter (int depth, bool8 hires, bool8 sub, bool8 mosaic)
 
 #define CLIP_10_BIT_SIGNED(a)	(((a) & 0x2000) ? ((a) | ~0x3ff) : ((a) & 0x3ff))
 
-extern struct SLineMatrixData	LineMatrixData[240];
-
 #define NO_INTERLACE	1
 #define Z1				(D + 7)
 #define Z2				(D + 7)
 #define MASK			0xff
-#define DCMODE			(Memory.FillRAM[0x2130] & 1)
+#define DCMODE			(GFX.FillRAM[0x2130] & 1)
 #define BG				0
 
 #define DRAW_TILE_NORMAL() \
-	uint8	*VRAM1 = Memory.VRAM + 1; \
+	uint8	*VRAM1 = GFX.VRAM + 1; \
 	\
 	if (DCMODE) \
 	{ \
@@ -1091,15 +1460,18 @@ extern struct SLineMatrixData	LineMatrixData[240];
 		\
 		uint8	Pix; \
 		\
-		if (!PPU.Mode7Repeat) \
+		/* The line is affine, so if both ends are on the 1024x1024 plane every pixel between is too */ \
+		int	LastX = (AA + BB + (int) (Right - 1 - Left) * aa) >> 8; \
+		int	LastY = (CC + DD + (int) (Right - 1 - Left) * cc) >> 8; \
+		\
+		if (!PPU.Mode7Repeat || ((((AA + BB) >> 8) | ((CC + DD) >> 8) | LastX | LastY) & ~0x3ff) == 0) \
 		{ \
-			for (uint32 x = Left; x < Right; x++, AA += aa, CC += cc) \
+			uint8	Pixels[256]; \
+			FetchMode7Line(Pixels, GFX.VRAM, Right - Left, AA + BB, CC + DD, aa, cc); \
+			\
+			for (uint32 x = Left; x < Right; x++) \
 			{ \
-				int	X = ((AA + BB) >> 8) & 0x3ff; \
-				int	Y = ((CC + DD) >> 8) & 0x3ff; \
-				\
-				uint8	*TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7); \
-				uint8	b = *(TileData + ((Y & 7) << 4) + ((X & 7) << 1)); \
+				uint8	b = Pixels[x - Left]; \
 				\
 				DRAW_PIXEL(x, Pix = (b & MASK)); \
 			} \
@@ -1115,7 +1487,7 @@ extern struct SLineMatrixData	LineMatrixData[240];
 				\
 				if (((X | Y) & ~0x3ff) == 0) \
 				{ \
-					uint8	*TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7); \
+					uint8	*TileData = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7); \
 					b = *(TileData + ((Y & 7) << 4) + ((X & 7) << 1)); \
 				} \
 				else \
@@ -1130,7 +1502,7 @@ extern struct SLineMatrixData	LineMatrixData[240];
 	}
 
 #define DRAW_TILE_MOSAIC() \
-	uint8	*VRAM1 = Memory.VRAM + 1; \
+	uint8	*VRAM1 = GFX.VRAM + 1; \
 	\
 	if (DCMODE) \
 	{ \
@@ -1221,7 +1593,7 @@ extern struct SLineMatrixData	LineMatrixData[240];
 				int	X = ((AA + BB) >> 8) & 0x3ff; \
 				int	Y = ((CC + DD) >> 8) & 0x3ff; \
 				\
-				uint8	*TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7); \
+				uint8	*TileData = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7); \
 				uint8	b = *(TileData + ((Y & 7) << 4) + ((X & 7) << 1)); \
 				\
 				if ((Pix = (b & MASK))) \
@@ -1249,7 +1621,7 @@ extern struct SLineMatrixData	LineMatrixData[240];
 				\
 				if (((X | Y) & ~0x3ff) == 0) \
 				{ \
-					uint8	*TileData = VRAM1 + (Memory.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7); \
+					uint8	*TileData = VRAM1 + (GFX.VRAM[((Y & ~7) << 5) + ((X >> 2) & ~1)] << 7); \
 					b = *(TileData + ((Y & 7) << 4) + ((X & 7) << 1)); \
 				} \
 				else \
@@ -1349,15 +1721,19 @@ extern struct SLineMatrixData	LineMatrixData[240];
 		GFX.DB[Offset + N] = Z2; \
 	}
 
-#define NAME2	Normal1x1
+#define NAME2		Normal1x1
+#define VECTOR_ROW	1
 
 // Third-level include: Get the Normal1x1 renderers.
 
 #include "tile.cpp"
 
 #undef NAME2
+#undef VECTOR_ROW
 #undef DRAW_PIXEL
 
+#define VECTOR_ROW	0
+
 // The 2x1 pixel plotter, for normal rendering when we've used hires/interlace already this frame.
 
 #define DRAW_PIXEL_N2x1(N, M) \
@@ -1439,6 +1815,7 @@ extern struct SLineMatrixData	LineMatrixData[240];
 
 #undef BPSTART
 #undef PITCH
+#undef VECTOR_ROW
 
 /*****************************************************************************/
 #else // Third-level: Renderers for each math mode for NAME1 + NAME2.
@@ -1447,66 +1824,111 @@ extern struct SLineMatrixData	LineMatrixData[240];
 #define CONCAT3(A, B, C)	A##B##C
 #define MAKENAME(A, B, C)	CONCAT3(A, B, C)
 
+// Plain drawing is the same for every pixel format, while the math renderers are templates
+// instantiated for each Math format of pixform.h, so they see its masks as constants.
+
 static void MAKENAME(NAME1, _, NAME2) (ARGS)
 {
 #define MATH(A, B, C)	NOMATH(x, A, B, C)
+#define VMATH(A, B, C)	VNOMATH(x, A, B, C)
+#define VECTOR_MATH		TRUE
 	DRAW_TILE();
 #undef MATH
+#undef VMATH
+#undef VECTOR_MATH
 }
 
+#define VECTOR_MATH		(PixelFormat<FMT>::AlphaBits == 0)
+
+template <int FMT>
 static void MAKENAME(NAME1, Add_, NAME2) (ARGS)
 {
-#define MATH(A, B, C)	REGMATH(ADD, A, B, C)
+#define MATH(A, B, C)	REGMATH(Add, A, B, C)
+#define VMATH(A, B, C)	VREGMATH(Add, A, B, C)
 	DRAW_TILE();
 #undef MATH
+#undef VMATH
 }
 
+template <int FMT>
 static void MAKENAME(NAME1, AddF1_2_, NAME2) (ARGS)
 {
-#define MATH(A, B, C)	MATHF1_2(ADD, A, B, C)
+#define MATH(A, B, C)	MATHF1_2(Add, A, B, C)
+#define VMATH(A, B, C)	VMATHF1_2(Add, A, B, C)
 	DRAW_TILE();
 #undef MATH
+#undef VMATH
 }
 
+template <int FMT>
 static void MAKENAME(NAME1, AddS1_2_, NAME2) (ARGS)
 {
-#define MATH(A, B, C)	MATHS1_2(ADD, A, B, C)
+#define MATH(A, B, C)	MATHS1_2(Add, A, B, C)
+#define VMATH(A, B, C)	VMATHS1_2(Add, A, B, C)
 	DRAW_TILE();
 #undef MATH
+#undef VMATH
 }
 
+template <int FMT>
 static void MAKENAME(NAME1, Sub_, NAME2) (ARGS)
 {
-#define MATH(A, B, C)	REGMATH(SUB, A, B, C)
+#define MATH(A, B, C)	REGMATH(Sub, A, B, C)
+#define VMATH(A, B, C)	VREGMATH(Sub, A, B, C)
 	DRAW_TILE();
 #undef MATH
+#undef VMATH
 }
 
+template <int FMT>
 static void MAKENAME(NAME1, SubF1_2_, NAME2) (ARGS)
 {
-#define MATH(A, B, C)	MATHF1_2(SUB, A, B, C)
+#define MATH(A, B, C)	MATHF1_2(Sub, A, B, C)
+#define VMATH(A, B, C)	VMATHF1_2(Sub, A, B, C)
 	DRAW_TILE();
 #undef MATH
+#undef VMATH
 }
 
+template <int FMT>
 static void MAKENAME(NAME1, SubS1_2_, NAME2) (ARGS)
 {
-#define MATH(A, B, C)	MATHS1_2(SUB, A, B, C)
+#define MATH(A, B, C)	MATHS1_2(Sub, A, B, C)
+#define VMATH(A, B, C)	VMATHS1_2(Sub, A, B, C)
 	DRAW_TILE();
 #undef MATH
+#undef VMATH
 }
 
-static void (*MAKENAME(Renderers_, NAME1, NAME2)[7]) (ARGS) =
+#undef VECTOR_MATH
+
+#define RENDERERS(F) \
+	{ \
+		MAKENAME(NAME1, _, NAME2), \
+		MAKENAME(NAME1, Add_, NAME2)<PixelFormat<F>::Math>, \
+		MAKENAME(NAME1, AddF1_2_, NAME2)<PixelFormat<F>::Math>, \
+		MAKENAME(NAME1, AddS1_2_, NAME2)<PixelFormat<F>::Math>, \
+		MAKENAME(NAME1, Sub_, NAME2)<PixelFormat<F>::Math>, \
+		MAKENAME(NAME1, SubF1_2_, NAME2)<PixelFormat<F>::Math>, \
+		MAKENAME(NAME1, SubS1_2_, NAME2)<PixelFormat<F>::Math> \
+	}
+
+static void (*MAKENAME(Renderers_, NAME1, NAME2)[PIXEL_FORMATS][7]) (ARGS) =
 {
-	MAKENAME(NAME1, _, NAME2),
-	MAKENAME(NAME1, Add_, NAME2),
-	MAKENAME(NAME1, AddF1_2_, NAME2),
-	MAKENAME(NAME1, AddS1_2_, NAME2),
-	MAKENAME(NAME1, Sub_, NAME2),
-	MAKENAME(NAME1, SubF1_2_, NAME2),
-	MAKENAME(NAME1, SubS1_2_, NAME2)
+#ifdef GFX_MULTI_FORMAT
+	RENDERERS(RGB565),
+	RENDERERS(RGB555),
+	RENDERERS(BGR565),
+	RENDERERS(BGR555),
+	RENDERERS(GBR565),
+	RENDERERS(GBR555),
+	RENDERERS(RGB5551)
+#else
+	RENDERERS(0)
+#endif
 };
 
+#undef RENDERERS
 #undef MAKENAME
 #undef CONCAT3
 
@@ -0,0 +1,1127 @@
+/***********************************************************************************
+  Snes9x - Portable Super Nintendo Entertainment System (TM) emulator.
+
+  (c) Copyright 1996 - 2002  Gary Henderson (gary.henderson@ntlworld.com),
+                             Jerremy Koot (jkoot@snes9x.com)
+
+  (c) Copyright 2002 - 2004  Matthew Kendora
+
+  (c) Copyright 2002 - 2005  Peter Bortas (peter@bortas.org)
+
+  (c) Copyright 2004 - 2005  Joel Yliluoma (http://iki.fi/bisqwit/)
+
+  (c) Copyright 2001 - 2006  John Weidman (jweidman@slip.net)
+
+  (c) Copyright 2002 - 2006  funkyass (funkyass@spam.shaw.ca),
+                             Kris Bleakley (codeviolation@hotmail.com)
+
+  (c) Copyright 2002 - 2010  Brad Jorsch (anomie@users.sourceforge.net),
+                             Nach (n-a-c-h@users.sourceforge.net),
+
+  (c) Copyright 2002 - 2011  zones (kasumitokoduck@yahoo.com)
+
+  (c) Copyright 2006 - 2007  nitsuja
+
+  (c) Copyright 2009 - 2011  BearOso,
+                             OV2
+
+
+  BS-X C emulator code
+  (c) Copyright 2005 - 2006  Dreamer Nom,
+                             zones
+
+  C4 x86 assembler and some C emulation code
+  (c) Copyright 2000 - 2003  _Demo_ (_demo_@zsnes.com),
+                             Nach,
+                             zsKnight (zsknight@zsnes.com)
+
+  C4 C++ code
+  (c) Copyright 2003 - 2006  Brad Jorsch,
+                             Nach
+
+  DSP-1 emulator code
+  (c) Copyright 1998 - 2006  _Demo_,
+                             Andreas Naive (andreasnaive@gmail.com),
+                             Gary Henderson,
+                             Ivar (ivar@snes9x.com),
+                             John Weidman,
+                             Kris Bleakley,
+                             Matthew Kendora,
+                             Nach,
+                             neviksti (neviksti@hotmail.com)
+
+  DSP-2 emulator code
+  (c) Copyright 2003         John Weidman,
+                             Kris Bleakley,
+                             Lord Nightmare (lord_nightmare@users.sourceforge.net),
+                             Matthew Kendora,
+                             neviksti
+
+  DSP-3 emulator code
+  (c) Copyright 2003 - 2006  John Weidman,
+                             Kris Bleakley,
+                             Lancer,
+                             z80 gaiden
+
+  DSP-4 emulator code
+  (c) Copyright 2004 - 2006  Dreamer Nom,
+                             John Weidman,
+                             Kris Bleakley,
+                             Nach,
+                             z80 gaiden
+
+  OBC1 emulator code
+  (c) Copyright 2001 - 2004  zsKnight,
+                             pagefault (pagefault@zsnes.com),
+                             Kris Bleakley
+                             Ported from x86 assembler to C by sanmaiwashi
+
+  SPC7110 and RTC C++ emulator code used in 1.39-1.51
+  (c) Copyright 2002         Matthew Kendora with research by
+                             zsKnight,
+                             John Weidman,
+                             Dark Force
+
+  SPC7110 and RTC C++ emulator code used in 1.52+
+  (c) Copyright 2009         byuu,
+                             neviksti
+
+  S-DD1 C emulator code
+  (c) Copyright 2003         Brad Jorsch with research by
+                             Andreas Naive,
+                             John Weidman
+
+  S-RTC C emulator code
+  (c) Copyright 2001 - 2006  byuu,
+                             John Weidman
+
+  ST010 C++ emulator code
+  (c) Copyright 2003         Feather,
+                             John Weidman,
+                             Kris Bleakley,
+                             Matthew Kendora
+
+  Super FX x86 assembler emulator code
+  (c) Copyright 1998 - 2003  _Demo_,
+                             pagefault,
+                             zsKnight
+
+  Super FX C emulator code
+  (c) Copyright 1997 - 1999  Ivar,
+                             Gary Henderson,
+                             John Weidman
+
+  Sound emulator code used in 1.5-1.51
+  (c) Copyright 1998 - 2003  Brad Martin
+  (c) Copyright 1998 - 2006  Charles Bilyue'
+
+  Sound emulator code used in 1.52+
+  (c) Copyright 2004 - 2007  Shay Green (gblargg@gmail.com)
+
+  SH assembler code partly based on x86 assembler code
+  (c) Copyright 2002 - 2004  Marcus Comstedt (marcus@mc.pp.se)
+
+  2xSaI filter
+  (c) Copyright 1999 - 2001  Derek Liauw Kie Fa
+
+  HQ2x, HQ3x, HQ4x filters
+  (c) Copyright 2003         Maxim Stepin (maxim@hiend3d.com)
+
+  NTSC filter
+  (c) Copyright 2006 - 2007  Shay Green
+
+  GTK+ GUI code
+  (c) Copyright 2004 - 2011  BearOso
+
+  Win32 GUI code
+  (c) Copyright 2003 - 2006  blip,
+                             funkyass,
+                             Matthew Kendora,
+                             Nach,
+                             nitsuja
+  (c) Copyright 2009 - 2011  OV2
+
+  Mac OS GUI code
+  (c) Copyright 1998 - 2001  John Stiles
+  (c) Copyright 2001 - 2011  zones
+
+
+  Specific ports contains the works of other authors. See headers in
+  individual files.
+
+
+  Snes9x homepage: http://www.snes9x.com/
+
+  Permission to use, copy, modify and/or distribute Snes9x in both binary
+  and source form, for non-commercial purposes, is hereby granted without
+  fee, providing that this license information and copyright notice appear
+  with all copies and any derived work.
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event shall the authors be held liable for any damages
+  arising from the use of this software or it's derivatives.
+
+  Snes9x is freeware for PERSONAL USE only. Commercial users should
+  seek permission of the copyright holders first. Commercial use includes,
+  but is not limited to, charging money for Snes9x or software derived from
+  Snes9x, including Snes9x or derivatives in commercial game bundles, and/or
+  using Snes9x as a promotion for your commercial product.
+
+  The copyright holders request that bug fixes and improvements to the code
+  should be forwarded to them so everyone can benefit from the modifications
+  in future versions.
+
+  Super NES and Super Nintendo Entertainment System are trademarks of
+  Nintendo Co., Limited and its subsidiary companies.
+ ***********************************************************************************/
+
+
+// Headless port: runs the emulation core with no display, audio or input device
+// and without a frame limiter. Intended for batch runs, e.g. regression-testing
+// ROMs with a movie file, where many copies share one host.
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <ctype.h>
+#include <signal.h>
+#include <string.h>
+#ifdef HAVE_STRINGS_H
+#include <strings.h>
+#endif
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <time.h>
+
+#include "snes9x.h"
+#include "consolestate.h"
+#include "memmap.h"
+#include "cpuexec.h"
+#include "apu/apu.h"
+#include "ppu.h"
+#include "gfx.h"
+#include "snapshot.h"
+#include "controls.h"
+#include "cheats.h"
+#include "movie.h"
+#include "logger.h"
+#include "display.h"
+#include "conffile.h"
+#ifdef DEBUGGER
+#include "debug.h"
+#endif
+
+struct SHeadlessSettings
+{
+	uint32	MaxFrames;
+	uint32	ReportInterval;
+	uint32	Consoles;
+	uint32	OAMBench;
+	uint32	SA1Bench;
+	bool8	Quiet;
+	bool8	SaveSRAM;
+};
+
+struct SHeadlessStats
+{
+	uint32			EmulatedFrames;
+	uint32			RenderedFrames;
+	uint32			IntervalFrames;
+	int				LastWidth;
+	int				LastHeight;
+	struct timeval	Start;
+	struct timeval	IntervalStart;
+};
+
+static const char	*s9x_base_dir        = NULL,
+					*rom_filename        = NULL,
+					*snapshot_filename   = NULL,
+					*play_smv_filename   = NULL,
+					*record_smv_filename = NULL;
+
+static char		default_dir[PATH_MAX + 1];
+
+static const char	dirNames[13][32] =
+{
+	"",				// DEFAULT_DIR
+	"",				// HOME_DIR
+	"",				// ROMFILENAME_DIR
+	"rom",			// ROM_DIR
+	"sram",			// SRAM_DIR
+	"savestate",	// SNAPSHOT_DIR
+	"screenshot",	// SCREENSHOT_DIR
+	"spc",			// SPC_DIR
+	"cheat",		// CHEAT_DIR
+	"patch",		// IPS_DIR
+	"bios",			// BIOS_DIR
+	"log",			// LOG_DIR
+	""
+};
+
+static SHeadlessSettings	headlessSettings;
+static SHeadlessStats		stats;
+
+#define MAX_CONSOLES	16
+
+static S9xConsoleState	*consoles[MAX_CONSOLES];
+static uint8			*snes_buffer[MAX_CONSOLES];
+static volatile bool8	stop_requested = FALSE;
+
+static double ElapsedSeconds (const struct timeval *, const struct timeval *);
+static void ReportFrameRate (const char *, uint32, double);
+static uint32 HashScreen (int, int);
+static int make_snes9x_dirs (void);
+
+
+void _splitpath (const char *path, char *drive, char *dir, char *fname, char *ext)
+{
+	*drive = 0;
+
+	const char	*slash = strrchr(path, SLASH_CHAR),
+				*dot   = strrchr(path, '.');
+
+	if (dot && slash && dot < slash)
+		dot = NULL;
+
+	if (!slash)
+	{
+		*dir = 0;
+
+		strcpy(fname, path);
+
+		if (dot)
+		{
+			fname[dot - path] = 0;
+			strcpy(ext, dot + 1);
+		}
+		else
+			*ext = 0;
+	}
+	else
+	{
+		strcpy(dir, path);
+		dir[slash - path] = 0;
+
+		strcpy(fname, slash + 1);
+
+		if (dot)
+		{
+			fname[dot - slash - 1] = 0;
+			strcpy(ext, dot + 1);
+		}
+		else
+			*ext = 0;
+	}
+}
+
+void _makepath (char *path, const char *, const char *dir, const char *fname, const char *ext)
+{
+	if (dir && *dir)
+	{
+		strcpy(path, dir);
+		strcat(path, SLASH_STR);
+	}
+	else
+		*path = 0;
+
+	strcat(path, fname);
+
+	if (ext && *ext)
+	{
+		strcat(path, ".");
+		strcat(path, ext);
+	}
+}
+
+static double ElapsedSeconds (const struct timeval *from, const struct timeval *to)
+{
+	return ((double) (to->tv_sec - from->tv_sec) + (double) (to->tv_usec - from->tv_usec) / 1000000.0);
+}
+
+// Times OAM uploads the way a game does them in VBlank: 544 writes to $2104,
+// followed by the sprite line setup the next frame needs. Each pass moves no
+// sprite, one sprite, or all of them.
+static void RunOAMBenchmark (uint32 uploads)
+{
+	static const char	*names[3] = { "none moved", "one moved", "all moved" };
+	uint8				oam[544];
+
+	for (int s = 0; s < 128; s++)
+	{
+		oam[s * 4 + 0] = (uint8) (s * 19);
+		oam[s * 4 + 1] = (uint8) (s * 53 % 224);
+		oam[s * 4 + 2] = (uint8) s;
+		oam[s * 4 + 3] = 0x30;
+	}
+
+	for (int i = 0; i < 32; i++)
+		oam[512 + i] = 0xaa;
+
+	IPPU.RenderThisFrame = FALSE;
+	S9xSetPPU(0x02, 0x2101);
+
+	for (int pass = 0; pass < 3; pass++)
+	{
+		struct timeval	start, now;
+
+		gettimeofday(&start, NULL);
+
+		for (uint32 n = 0; n < uploads; n++)
+		{
+			if (pass == 1)
+				oam[5 * 4 + 1]++;
+			else
+			if (pass == 2)
+				for (int s = 0; s < 128; s++)
+					oam[s * 4]++;
+
+			S9xSetPPU(0, 0x2102);
+			S9xSetPPU(0, 0x2103);
+			for (int i = 0; i < 544; i++)
+				S9xSetPPU(oam[i], 0x2104);
+
+			IPPU.PreviousLine = IPPU.CurrentLine = 0;
+			RenderLine(0);
+		}
+
+		gettimeofday(&now, NULL);
+
+		double	seconds = ElapsedSeconds(&start, &now);
+		fprintf(stdout, "OAM upload, %s: %u in %.3f s, %.3f us each\n", names[pass], uploads, seconds, seconds * 1000000.0 / uploads);
+	}
+
+	fflush(stdout);
+}
+
+// Times the same frames of an SA-1 game with the SA-1 stepped after every
+// S-CPU instruction and with Settings.SA1TimeSlice. Every pass starts from a
+// reset, and the modes take turns. CPU time is counted, not wall time, so a
+// busy host skews the two modes less.
+static void RunSA1Benchmark (uint32 frames)
+{
+	static const char	*names[2] = { "per instruction", "time sliced" };
+	double				best[2] = { 0.0, 0.0 };
+	uint32				hash[2] = { 0, 0 };
+
+	if (!Settings.SA1)
+	{
+		fprintf(stderr, "Snes9x: -sa1bench needs an SA-1 cartridge.\n");
+		exit(1);
+	}
+
+	// Only this function decides when to stop.
+	headlessSettings.MaxFrames = 0;
+	headlessSettings.ReportInterval = 0;
+
+	for (int round = 0; round < 5; round++)
+	{
+		for (int mode = 0; mode < 2; mode++)
+		{
+			Settings.SA1TimeSlice = mode;
+			S9xReset();
+			Memory.map_Pages();
+			S9xSelectMainLoop();
+
+			clock_t	start = clock();
+
+			for (uint32 n = 0; n < frames; n++)
+				S9xMainLoop();
+
+			double	seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+			if (round == 0 || seconds < best[mode])
+				best[mode] = seconds;
+
+			hash[mode] = HashScreen(stats.LastWidth, stats.LastHeight);
+		}
+	}
+
+	for (int mode = 0; mode < 2; mode++)
+		fprintf(stdout, "SA-1 %s: %u frames in %.3f s, %.2f frames/s, last frame hash %08X\n", names[mode], frames, best[mode], frames / best[mode], hash[mode]);
+
+	fprintf(stdout, "Time sliced SA-1: %.3f times the per instruction frame rate\n", best[0] / best[1]);
+	fflush(stdout);
+}
+
+static void ReportFrameRate (const char *label, uint32 frames, double seconds)
+{
+	if (seconds <= 0.0)
+		seconds = 0.000001;
+
+	fprintf(stdout, "%s: %u frames in %.3f s, %.2f frames/s\n", label, frames, seconds, frames / seconds);
+	fflush(stdout);
+}
+
+// FNV-1a over the visible part of GFX.Screen, so that batch runs can compare
+// the final picture without writing a screenshot.
+static uint32 HashScreen (int width, int height)
+{
+	uint32	hash = 2166136261u;
+
+	for (int y = 0; y < height; y++)
+	{
+		const uint8	*p = (const uint8 *) GFX.Screen + y * GFX.Pitch;
+
+		for (int x = 0; x < width * (int) sizeof(pixel_t); x++)
+			hash = (hash ^ p[x]) * 16777619u;
+	}
+
+	return (hash);
+}
+
+void S9xExtraUsage (void)
+{
+	/*                               12345678901234567890123456789012345678901234567890123456789012345678901234567890 */
+
+	S9xMessage(S9X_INFO, S9X_USAGE, "-multi                          Enable multi cartridge system");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-carta <filename>               ROM in slot A (use with -multi)");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-cartb <filename>               ROM in slot B (use with -multi)");
+	S9xMessage(S9X_INFO, S9X_USAGE, "");
+
+	S9xMessage(S9X_INFO, S9X_USAGE, "-frames <num>                   Exit after emulating specified number of frames");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-reportinterval <num>           Print frame rate every specified number of frames");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-consoles <num>                 Load the ROM into specified number of consoles and");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                run them in turn, one frame each");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-oambench <num>                 Time specified number of OAM uploads and exit");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-sa1bench <num>                 Time specified number of frames with and without");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                SA-1 time slicing and exit");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-quiet                          Do not print emulator messages");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-savesram                       Write SRAM to disk on exit");
+	S9xMessage(S9X_INFO, S9X_USAGE, "");
+
+	S9xMessage(S9X_INFO, S9X_USAGE, "-loadsnapshot                   Load snapshot file at start");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-playmovie <filename>           Start emulator playing the .smv file");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-recordmovie <filename>         Start emulator recording the .smv file");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-dumpstreams                    Save audio/video data to disk");
+	S9xMessage(S9X_INFO, S9X_USAGE, "-dumpmaxframes <num>            Stop emulator after saving specified number of");
+	S9xMessage(S9X_INFO, S9X_USAGE, "                                frames (use with -dumpstreams)");
+	S9xMessage(S9X_INFO, S9X_USAGE, "");
+}
+
+void S9xParseArg (char **argv, int &i, int argc)
+{
+	if (!strcasecmp(argv[i], "-multi"))
+		Settings.Multi = TRUE;
+	else
+	if (!strcasecmp(argv[i], "-carta"))
+	{
+		if (i + 1 < argc)
+			strncpy(Settings.CartAName, argv[++i], _MAX_PATH);
+		else
+			S9xUsage();
+	}
+	else
+	if (!strcasecmp(argv[i], "-cartb"))
+	{
+		if (i + 1 < argc)
+			strncpy(Settings.CartBName, argv[++i], _MAX_PATH);
+		else
+			S9xUsage();
+	}
+	else
+	if (!strcasecmp(argv[i], "-frames"))
+	{
+		if (i + 1 < argc)
+			headlessSettings.MaxFrames = atoi(argv[++i]);
+		else
+			S9xUsage();
+	}
+	else
+	if (!strcasecmp(argv[i], "-reportinterval"))
+	{
+		if (i + 1 < argc)
+			headlessSettings.ReportInterval = atoi(argv[++i]);
+		else
+			S9xUsage();
+	}
+	else
+	if (!strcasecmp(argv[i], "-consoles"))
+	{
+		if (i + 1 < argc)
+			headlessSettings.Consoles = atoi(argv[++i]);
+		else
+			S9xUsage();
+	}
+	else
+	if (!strcasecmp(argv[i], "-oambench"))
+	{
+		if (i + 1 < argc)
+			headlessSettings.OAMBench = atoi(argv[++i]);
+		else
+			S9xUsage();
+	}
+	else
+	if (!strcasecmp(argv[i], "-sa1bench"))
+	{
+		if (i + 1 < argc)
+			headlessSettings.SA1Bench = atoi(argv[++i]);
+		else
+			S9xUsage();
+	}
+	else
+	if (!strcasecmp(argv[i], "-quiet"))
+		headlessSettings.Quiet = TRUE;
+	else
+	if (!strcasecmp(argv[i], "-savesram"))
+		headlessSettings.SaveSRAM = TRUE;
+	else
+	if (!strcasecmp(argv[i], "-loadsnapshot"))
+	{
+		if (i + 1 < argc)
+			snapshot_filename = argv[++i];
+		else
+			S9xUsage();
+	}
+	else
+	if (!strcasecmp(argv[i], "-playmovie"))
+	{
+		if (i + 1 < argc)
+			play_smv_filename = argv[++i];
+		else
+			S9xUsage();
+	}
+	else
+	if (!strcasecmp(argv[i], "-recordmovie"))
+	{
+		if (i + 1 < argc)
+			record_smv_filename = argv[++i];
+		else
+			S9xUsage();
+	}
+	else
+	if (!strcasecmp(argv[i], "-dumpstreams"))
+		Settings.DumpStreams = TRUE;
+	else
+	if (!strcasecmp(argv[i], "-dumpmaxframes"))
+	{
+		if (i + 1 < argc)
+			Settings.DumpStreamsMaxFrames = atoi(argv[++i]);
+		else
+			S9xUsage();
+	}
+	else
+		S9xUsage();
+}
+
+void S9xParsePortConfig (ConfigFile &conf, int pass)
+{
+	s9x_base_dir                    = conf.GetStringDup("Unix::BaseDir",             default_dir);
+	snapshot_filename               = conf.GetStringDup("Unix::SnapshotFilename",    NULL);
+	play_smv_filename               = conf.GetStringDup("Unix::PlayMovieFilename",   NULL);
+	record_smv_filename             = conf.GetStringDup("Unix::RecordMovieFilename", NULL);
+
+	headlessSettings.MaxFrames      = conf.GetUInt     ("Headless::Frames",          0);
+	headlessSettings.ReportInterval = conf.GetUInt     ("Headless::ReportInterval",  0);
+	headlessSettings.Consoles       = conf.GetUInt     ("Headless::Consoles",        1);
+	headlessSettings.Quiet          = conf.GetBool     ("Headless::Quiet",           false);
+	headlessSettings.SaveSRAM       = conf.GetBool     ("Headless::SaveSRAM",        false);
+}
+
+static int make_snes9x_dirs (void)
+{
+	if (strlen(s9x_base_dir) + 1 + sizeof(dirNames[0]) > PATH_MAX + 1)
+		return (-1);
+
+	mkdir(s9x_base_dir, 0755);
+
+	for (int i = 0; i < LAST_DIR; i++)
+	{
+		if (dirNames[i][0])
+		{
+			char	s[PATH_MAX + 1];
+			snprintf(s, PATH_MAX + 1, "%s%s%s", s9x_base_dir, SLASH_STR, dirNames[i]);
+			mkdir(s, 0755);
+		}
+	}
+
+	return (0);
+}
+
+const char * S9xGetDirectory (enum s9x_getdirtype dirtype)
+{
+	static char	s[PATH_MAX + 1];
+
+	if (dirNames[dirtype][0])
+		snprintf(s, PATH_MAX + 1, "%s%s%s", s9x_base_dir, SLASH_STR, dirNames[dirtype]);
+	else
+	{
+		switch (dirtype)
+		{
+			case DEFAULT_DIR:
+				strncpy(s, s9x_base_dir, PATH_MAX + 1);
+				s[PATH_MAX] = 0;
+				break;
+
+			case HOME_DIR:
+				strncpy(s, getenv("HOME"), PATH_MAX + 1);
+				s[PATH_MAX] = 0;
+				break;
+
+			case ROMFILENAME_DIR:
+				strncpy(s, Memory.ROMFilename, PATH_MAX + 1);
+				s[PATH_MAX] = 0;
+
+				for (int i = strlen(s); i >= 0; i--)
+				{
+					if (s[i] == SLASH_CHAR)
+					{
+						s[i] = 0;
+						break;
+					}
+				}
+
+				break;
+
+			default:
+				s[0] = 0;
+				break;
+		}
+	}
+
+	return (s);
+}
+
+const char * S9xGetFilename (const char *ex, enum s9x_getdirtype dirtype)
+{
+	static char	s[PATH_MAX + 1];
+	char		drive[_MAX_DRIVE + 1], dir[_MAX_DIR + 1], fname[_MAX_FNAME + 1], ext[_MAX_EXT + 1];
+
+	_splitpath(Memory.ROMFilename, drive, dir, fname, ext);
+	snprintf(s, PATH_MAX + 1, "%s%s%s%s", S9xGetDirectory(dirtype), SLASH_STR, fname, ex);
+
+	return (s);
+}
+
+const char * S9xGetFilenameInc (const char *ex, enum s9x_getdirtype dirtype)
+{
+	static char	s[PATH_MAX + 1];
+	char		drive[_MAX_DRIVE + 1], dir[_MAX_DIR + 1], fname[_MAX_FNAME + 1], ext[_MAX_EXT + 1];
+
+	unsigned int	i = 0;
+	const char		*d;
+	struct stat		buf;
+
+	_splitpath(Memory.ROMFilename, drive, dir, fname, ext);
+	d = S9xGetDirectory(dirtype);
+
+	do
+		snprintf(s, PATH_MAX + 1, "%s%s%s.%03d%s", d, SLASH_STR, fname, i++, ex);
+	while (stat(s, &buf) == 0 && i < 1000);
+
+	return (s);
+}
+
+const char * S9xBasename (const char *f)
+{
+	const char	*p;
+
+	if ((p = strrchr(f, '/')) != NULL || (p = strrchr(f, '\\')) != NULL)
+		return (p + 1);
+
+	return (f);
+}
+
+// There is nobody to answer a prompt in a batch run.
+
+const char * S9xSelectFilename (const char *def, const char *dir1, const char *ext1, const char *title)
+{
+	return (NULL);
+}
+
+const char * S9xChooseFilename (bool8 read_only)
+{
+	return (NULL);
+}
+
+const char * S9xChooseMovieFilename (bool8 read_only)
+{
+	return (NULL);
+}
+
+const char * S9xStringInput (const char *message)
+{
+	return (NULL);
+}
+
+bool8 S9xOpenSnapshotFile (const char *filename, bool8 read_only, STREAM *file)
+{
+	char	s[PATH_MAX + 1];
+	char	drive[_MAX_DRIVE + 1], dir[_MAX_DIR + 1], fname[_MAX_FNAME + 1], ext[_MAX_EXT + 1];
+
+	_splitpath(filename, drive, dir, fname, ext);
+
+	if (*drive || *dir == SLASH_CHAR || (strlen(dir) > 1 && *dir == '.' && *(dir + 1) == SLASH_CHAR))
+	{
+		strncpy(s, filename, PATH_MAX + 1);
+		s[PATH_MAX] = 0;
+	}
+	else
+		snprintf(s, PATH_MAX + 1, "%s%s%s", S9xGetDirectory(SNAPSHOT_DIR), SLASH_STR, fname);
+
+	if (!*ext && strlen(s) <= PATH_MAX - 4)
+		strcat(s, ".frz");
+
+	if ((*file = OPEN_STREAM(s, read_only ? "rb" : "wb")))
+		return (TRUE);
+
+	return (FALSE);
+}
+
+void S9xCloseSnapshotFile (STREAM file)
+{
+	CLOSE_STREAM(file);
+}
+
+void S9xMessage (int type, int number, const char *message)
+{
+	if (headlessSettings.Quiet && type != S9X_ERROR && type != S9X_FATAL_ERROR)
+		return;
+
+	fprintf(stdout, "%s\n", message);
+}
+
+bool8 S9xInitUpdate (void)
+{
+	return (TRUE);
+}
+
+bool8 S9xDeinitUpdate (int width, int height)
+{
+	stats.RenderedFrames++;
+	stats.LastWidth = width;
+	stats.LastHeight = height;
+	return (TRUE);
+}
+
+bool8 S9xContinueUpdate (int width, int height)
+{
+	return (TRUE);
+}
+
+void S9xPutImage (int width, int height)
+{
+	return;
+}
+
+void S9xSetPalette (void)
+{
+	return;
+}
+
+void S9xTextMode (void)
+{
+	return;
+}
+
+void S9xGraphicsMode (void)
+{
+	return;
+}
+
+void S9xToggleSoundChannel (int c)
+{
+	return;
+}
+
+bool8 S9xOpenSoundDevice (void)
+{
+	// No device: the APU still runs, but S9xSetSoundMute keeps the output muted
+	// so no samples are resampled or mixed.
+	return (FALSE);
+}
+
+void S9xAutoSaveSRAM (void)
+{
+	if (headlessSettings.SaveSRAM)
+		Memory.SaveSRAM(S9xGetFilename(".srm", SRAM_DIR));
+}
+
+void S9xSyncSpeed (void)
+{
+	// No frame limiter: every frame is emulated as fast as the host allows.
+
+	if (Settings.HighSpeedSeek > 0)
+		Settings.HighSpeedSeek--;
+
+	stats.EmulatedFrames++;
+	stats.IntervalFrames++;
+
+	if (Settings.SkipFrames == AUTO_FRAMERATE || Settings.SkipFrames <= 1)
+	{
+		IPPU.RenderThisFrame = TRUE;
+		IPPU.SkippedFrames = 0;
+	}
+	else
+	{
+		IPPU.RenderThisFrame = (++IPPU.SkippedFrames >= Settings.SkipFrames) ? TRUE : FALSE;
+		if (IPPU.RenderThisFrame)
+			IPPU.SkippedFrames = 0;
+	}
+
+	if (headlessSettings.ReportInterval && stats.IntervalFrames >= headlessSettings.ReportInterval)
+	{
+		struct timeval	now;
+
+		while (gettimeofday(&now, NULL) == -1) ;
+		ReportFrameRate("Interval", stats.IntervalFrames, ElapsedSeconds(&stats.IntervalStart, &now));
+
+		stats.IntervalFrames = 0;
+		stats.IntervalStart = now;
+	}
+
+	if (stop_requested || (headlessSettings.MaxFrames && stats.EmulatedFrames >= headlessSettings.MaxFrames * headlessSettings.Consoles))
+		S9xExit();
+}
+
+bool S9xPollButton (uint32 id, bool *pressed)
+{
+	return (false);
+}
+
+bool S9xPollAxis (uint32 id, int16 *value)
+{
+	return (false);
+}
+
+bool S9xPollPointer (uint32 id, int16 *x, int16 *y)
+{
+	return (false);
+}
+
+void S9xHandlePortCommand (s9xcommand_t cmd, int16 data1, int16 data2)
+{
+	return;
+}
+
+void S9xExit (void)
+{
+	struct timeval	now;
+
+	while (gettimeofday(&now, NULL) == -1) ;
+
+	S9xMovieShutdown();
+
+	S9xSetSoundMute(TRUE);
+	Settings.StopEmulation = TRUE;
+
+	ReportFrameRate("Emulated", stats.EmulatedFrames, ElapsedSeconds(&stats.Start, &now));
+	fprintf(stdout, "Rendered: %u frames, last frame hash %08X\n", stats.RenderedFrames, HashScreen(stats.LastWidth, stats.LastHeight));
+	if (IdleLoop.Skipped)
+		fprintf(stdout, "Idle loops: %.0f master cycles skipped\n", (double) IdleLoop.Skipped);
+
+	if (headlessSettings.SaveSRAM)
+		Memory.SaveSRAM(S9xGetFilename(".srm", SRAM_DIR));
+	S9xResetSaveTimer(FALSE);
+
+	S9xUnmapAllControls();
+
+	S9xConsoleState	*current = S9xCurrentConsoleState();
+
+	for (uint32 n = 0; n < headlessSettings.Consoles; n++)
+	{
+		if (consoles[n] != current)
+			S9xFreeConsoleState(consoles[n]);
+		free(snes_buffer[n]);
+		snes_buffer[n] = NULL;
+	}
+
+	S9xGraphicsDeinit();
+	Memory.Deinit();
+	S9xDeinitAPU();
+
+	exit(0);
+}
+
+static void sigterm (int)
+{
+	// Finish the current frame, then exit from S9xSyncSpeed.
+	stop_requested = TRUE;
+}
+
+static void InitConsole (uint32 n)
+{
+	if (!Memory.Init() || !S9xInitAPU())
+	{
+		fprintf(stderr, "Snes9x: Memory allocation failure - not enough RAM/virtual memory available.\nExiting...\n");
+		Memory.Deinit();
+		S9xDeinitAPU();
+		exit(1);
+	}
+
+	S9xInitSound(0, 0);
+	S9xSetSoundMute(TRUE);
+
+#ifdef GFX_MULTI_FORMAT
+	S9xSetRenderPixelFormat(RGB565);
+#endif
+
+	uint32	saved_flags = CPU.Flags;
+	bool8	loaded = FALSE;
+
+	if (Settings.Multi)
+		loaded = Memory.LoadMultiCart(Settings.CartAName, Settings.CartBName);
+	else
+	if (rom_filename)
+		loaded = Memory.LoadROM(rom_filename);
+
+	if (!loaded)
+	{
+		fprintf(stderr, "Error opening the ROM file.\n");
+		exit(1);
+	}
+
+	if (headlessSettings.SaveSRAM)
+		Memory.LoadSRAM(S9xGetFilename(".srm", SRAM_DIR));
+	S9xLoadCheatFile(S9xGetFilename(".cht", CHEAT_DIR));
+
+	CPU.Flags = saved_flags;
+	Settings.StopEmulation = FALSE;
+
+	GFX.Pitch = SNES_WIDTH * 2 * sizeof(pixel_t);
+	snes_buffer[n] = (uint8 *) calloc(GFX.Pitch * ((SNES_HEIGHT_EXTENDED + 4) * 2), 1);
+	if (!snes_buffer[n])
+	{
+		fprintf(stderr, "Snes9x: Memory allocation failure - not enough RAM/virtual memory available.\nExiting...\n");
+		exit(1);
+	}
+
+	GFX.Screen = (pixel_t *) (snes_buffer[n] + (GFX.Pitch * 2 * 2));
+	S9xGraphicsInit();
+}
+
+int main (int argc, char **argv)
+{
+	if (argc < 2)
+		S9xUsage();
+
+	snprintf(default_dir, PATH_MAX + 1, "%s%s%s", getenv("HOME"), SLASH_STR, ".snes9x");
+	s9x_base_dir = default_dir;
+
+	ZeroMemory(&Settings, sizeof(Settings));
+	Settings.MouseMaster = TRUE;
+	Settings.SuperScopeMaster = TRUE;
+	Settings.JustifierMaster = TRUE;
+	Settings.MultiPlayer5Master = TRUE;
+	Settings.FrameTimePAL = 20000;
+	Settings.FrameTimeNTSC = 16667;
+	Settings.SixteenBitSound = TRUE;
+	Settings.Stereo = TRUE;
+	Settings.SoundPlaybackRate = 32000;
+	Settings.SoundInputRate = 32000;
+	Settings.SupportHiRes = TRUE;
+	Settings.Transparency = TRUE;
+	Settings.AutoDisplayMessages = FALSE;
+	Settings.InitialInfoStringTimeout = 120;
+	Settings.HDMATimingHack = 100;
+	Settings.BlockInvalidVRAMAccessMaster = TRUE;
+	Settings.StopEmulation = TRUE;
+	Settings.WrongMovieStateProtection = TRUE;
+	Settings.DumpStreamsMaxFrames = -1;
+	Settings.StretchScreenshots = 1;
+	Settings.SnapshotScreenshots = TRUE;
+	Settings.SkipFrames = AUTO_FRAMERATE;
+	Settings.TurboSkipFrames = 15;
+	Settings.CartAName[0] = 0;
+	Settings.CartBName[0] = 0;
+
+	ZeroMemory(&headlessSettings, sizeof(headlessSettings));
+	headlessSettings.Consoles = 1;
+	ZeroMemory(&stats, sizeof(stats));
+
+	CPU.Flags = 0;
+
+	S9xLoadConfigFiles(argv, argc);
+	rom_filename = S9xParseArgs(argv, argc);
+
+	// Nothing consumes audio, so never wait for it.
+	Settings.SoundSync = FALSE;
+	Settings.AutoDisplayMessages = FALSE;
+
+	if (!headlessSettings.Quiet)
+		printf("\n\nSnes9x " VERSION " headless\n");
+
+	make_snes9x_dirs();
+
+	if (headlessSettings.Consoles < 1 || headlessSettings.Consoles > MAX_CONSOLES)
+	{
+		fprintf(stderr, "Snes9x: Number of consoles must be between 1 and %d.\n", MAX_CONSOLES);
+		exit(1);
+	}
+
+	if (headlessSettings.Consoles > 1 && !S9xConsoleStatesSupported())
+	{
+		fprintf(stderr, "Snes9x: -consoles cannot be combined with -renderthreads, -pipelinedrendering or -reuselines.\n");
+		exit(1);
+	}
+
+	for (uint32 n = 0; n < headlessSettings.Consoles; n++)
+	{
+		if (n == 0)
+			consoles[n] = S9xCurrentConsoleState();
+		else
+		{
+			consoles[n] = S9xNewConsoleState();
+			if (!consoles[n])
+			{
+				fprintf(stderr, "Snes9x: Memory allocation failure - not enough RAM/virtual memory available.\nExiting...\n");
+				exit(1);
+			}
+
+			S9xRestoreConsoleState(consoles[n]);
+		}
+
+		InitConsole(n);
+	}
+
+	// Movies and snapshots go to the first console.
+	S9xRestoreConsoleState(consoles[0]);
+
+	S9xUnmapAllControls();
+
+	if (play_smv_filename)
+	{
+		if (S9xMovieOpen(play_smv_filename, TRUE) != SUCCESS)
+			exit(1);
+	}
+	else
+	if (record_smv_filename)
+	{
+		if (S9xMovieCreate(record_smv_filename, 0xFF, MOVIE_OPT_FROM_RESET, NULL, 0) != SUCCESS)
+			exit(1);
+	}
+	else
+	if (snapshot_filename)
+	{
+		if (!S9xUnfreezeGame(snapshot_filename))
+			exit(1);
+	}
+
+	if (headlessSettings.OAMBench)
+	{
+		RunOAMBenchmark(headlessSettings.OAMBench);
+		exit(0);
+	}
+
+	if (headlessSettings.SA1Bench)
+	{
+		RunSA1Benchmark(headlessSettings.SA1Bench);
+		exit(0);
+	}
+
+	signal(SIGINT, sigterm);
+	signal(SIGTERM, sigterm);
+
+	while (gettimeofday(&stats.Start, NULL) == -1) ;
+	stats.IntervalStart = stats.Start;
+
+	for (;;)
+	{
+		for (uint32 n = 0; n < headlessSettings.Consoles; n++)
+		{
+			if (headlessSettings.Consoles > 1)
+				S9xRestoreConsoleState(consoles[n]);
+			S9xMainLoop();
+		}
+	}
+
+	return (0);
+}
@@ -296,7 +296,6 @@ static uint8			Buf[SOUND_BUFFER_SIZE];
 
 #ifdef USE_THREADS
 static pthread_t		thread;
-static pthread_mutex_t	mutex;
 #endif
 
 #ifdef JOYSTICK_SUPPORT
@@ -1367,7 +1366,6 @@ static void InitTimer (void)
 #ifdef USE_THREADS
 	if (unixSettings.ThreadSound)
 	{
-		pthread_mutex_init(&mutex, NULL);
 		pthread_create(&thread, NULL, S9xProcessSound, NULL);
 		return;
 	}
@@ -1450,10 +1448,10 @@ static void * S9xProcessSound (void *)
 	if (Settings.SixteenBitSound)
 		sample_count >>= 1;
 
+	// The sound thread mixes on its own: the resampler's ring buffer has one
+	// producer and one consumer, so S9xMixSamples needs no lock
 #ifdef USE_THREADS
-	if (unixSettings.ThreadSound)
-		pthread_mutex_lock(&mutex);
-	else
+	if (!unixSettings.ThreadSound)
 #endif
 	if (block_signal)
 		return (NULL);
@@ -1475,11 +1473,6 @@ static void * S9xProcessSound (void *)
 	so.play_position += bytes_to_write;
 	so.play_position &= SOUND_BUFFER_SIZE_MASK;
 
-#ifdef USE_THREADS
-	if (unixSettings.ThreadSound)
-		pthread_mutex_unlock(&mutex);
-#endif
-
 	block_generate_sound = FALSE;
 
 	for (;;)
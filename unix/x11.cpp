@@ -283,8 +283,10 @@ static void SetXRepeat (bool8);
 static void SetupImage (void);
 static void TakedownImage (void);
 static void Repaint (bool8);
+#if PIXEL_BITS == 16
 static void Convert16To24 (int, int);
 static void Convert16To24Packed (int, int);
+#endif
 
 
 void S9xExtraDisplayUsage (void)
@@ -525,6 +527,20 @@ void S9xInitDisplay (int argc, char **argv)
 
 	XFree(matches);
 
+#if PIXEL_BITS == 32
+	// The frame is drawn in the display's own format and goes to the image as it is
+	if (GUI.depth != 24 || GUI.red_shift != 16 || GUI.green_shift != 8 || GUI.blue_shift != 0)
+		FatalError("This build draws XRGB8888 pixels, which needs a 24 or 32-bit TrueColor display.");
+
+	GUI.pixel_format = 8888;
+
+	// The scaling filters only know 16-bit pixels
+	if (GUI.video_mode != VIDEOMODE_BLOCKY)
+	{
+		fprintf(stderr, "Only the Blocky video mode is available with XRGB8888 pixels.\n");
+		GUI.video_mode = VIDEOMODE_BLOCKY;
+	}
+#else
 	switch (GUI.depth)
 	{
 		default:
@@ -562,10 +578,13 @@ void S9xInitDisplay (int argc, char **argv)
 			GUI.pixel_format = 555;
 			break;
 	}
+#endif
 
 	S9xBlitFilterInit();
+#if PIXEL_BITS == 16
 	S9xBlit2xSaIFilterInit();
 	S9xBlitHQ2xFilterInit();
+#endif
 
 	XSetWindowAttributes	attrib;
 
@@ -628,6 +647,11 @@ void S9xInitDisplay (int argc, char **argv)
 			GUI.bytes_per_pixel = 2;
 			break;
 	}
+
+#if PIXEL_BITS == 32
+	if (GUI.bytes_per_pixel != 4)
+		FatalError("This build draws XRGB8888 pixels, which needs a 32-bit image format.");
+#endif
 }
 
 void S9xDeinitDisplay (void)
@@ -637,8 +661,10 @@ void S9xDeinitDisplay (void)
 	XSync(GUI.display, False);
 	XCloseDisplay(GUI.display);
 	S9xBlitFilterDeinit();
+#if PIXEL_BITS == 16
 	S9xBlit2xSaIFilterDeinit();
 	S9xBlitHQ2xFilterDeinit();
+#endif
 }
 
 static void TakedownImage (void)
@@ -751,18 +777,18 @@ static void SetupImage (void)
 	GUI.image->byte_order = MSBFirst;
 #endif
 
-	GFX.Pitch = SNES_WIDTH * 2 * 2;
+	GFX.Pitch = SNES_WIDTH * 2 * sizeof(pixel_t);
 	GUI.snes_buffer = (uint8 *) calloc(GFX.Pitch * ((SNES_HEIGHT_EXTENDED + 4) * 2), 1);
 	if (!GUI.snes_buffer)
 		FatalError("Failed to allocate GUI.snes_buffer.");
 
-	GFX.Screen = (uint16 *) (GUI.snes_buffer + (GFX.Pitch * 2 * 2));
+	GFX.Screen = (pixel_t *) (GUI.snes_buffer + (GFX.Pitch * 2 * 2));
 
 	GUI.filter_buffer = (uint8 *) calloc((SNES_WIDTH * 2) * 2 * (SNES_HEIGHT_EXTENDED * 2), 1);
 	if (!GUI.filter_buffer)
 		FatalError("Failed to allocate GUI.filter_buffer.");
 
-	if (GUI.depth == 15 || GUI.depth == 16)
+	if (GUI.depth == 15 || GUI.depth == 16 || PIXEL_BITS == 32)
 	{
 		GUI.blit_screen_pitch = GUI.image->bytes_per_line;
 		GUI.blit_screen       = (uint8 *) GUI.image->data;
@@ -781,7 +807,6 @@ static void SetupImage (void)
 void S9xPutImage (int width, int height)
 {
 	static int	prevWidth = 0, prevHeight = 0;
-	int			copyWidth, copyHeight;
 	Blitter		blitFn = NULL;
 
 	if (GUI.video_mode == VIDEOMODE_BLOCKY || GUI.video_mode == VIDEOMODE_TV || GUI.video_mode == VIDEOMODE_SMOOTH)
@@ -792,18 +817,14 @@ void S9xPutImage (int width, int height)
 	{
 		if (height > SNES_HEIGHT_EXTENDED)
 		{
-			copyWidth  = width * 2;
-			copyHeight = height;
 			blitFn = S9xBlitPixSimple2x1;
 		}
 		else
 		{
-			copyWidth  = width  * 2;
-			copyHeight = height * 2;
-
 			switch (GUI.video_mode)
 			{
 				case VIDEOMODE_BLOCKY:		blitFn = S9xBlitPixSimple2x2;		break;
+			#if PIXEL_BITS == 16
 				case VIDEOMODE_TV:			blitFn = S9xBlitPixTV2x2;			break;
 				case VIDEOMODE_SMOOTH:		blitFn = S9xBlitPixSmooth2x2;		break;
 				case VIDEOMODE_SUPEREAGLE:	blitFn = S9xBlitPixSuperEagle16;	break;
@@ -811,25 +832,23 @@ void S9xPutImage (int width, int height)
 				case VIDEOMODE_SUPER2XSAI:	blitFn = S9xBlitPixSuper2xSaI16;	break;
 				case VIDEOMODE_EPX:			blitFn = S9xBlitPixEPX16;			break;
 				case VIDEOMODE_HQ2X:		blitFn = S9xBlitPixHQ2x16;			break;
+			#endif
 			}
 		}
 	}
 	else
 	if (height <= SNES_HEIGHT_EXTENDED)
 	{
-		copyWidth  = width;
-		copyHeight = height * 2;
-
 		switch (GUI.video_mode)
 		{
 			default:					blitFn = S9xBlitPixSimple1x2;	break;
+		#if PIXEL_BITS == 16
 			case VIDEOMODE_TV:			blitFn = S9xBlitPixTV1x2;		break;
+		#endif
 		}
 	}
 	else
 	{
-		copyWidth  = width;
-		copyHeight = height;
 		blitFn = S9xBlitPixSimple1x1;
 	}
 
@@ -846,13 +865,18 @@ void S9xPutImage (int width, int height)
 		}
 	}
 
+#if PIXEL_BITS == 16
 	if (GUI.need_convert)
 	{
+		int	copyWidth  = (width  <= SNES_WIDTH)           ? width  * 2 : width;
+		int	copyHeight = (height <= SNES_HEIGHT_EXTENDED) ? height * 2 : height;
+
 		if (GUI.bytes_per_pixel == 3)
 			Convert16To24Packed(copyWidth, copyHeight);
 		else
 			Convert16To24(copyWidth, copyHeight);
 	}
+#endif
 
 	Repaint(TRUE);
 
@@ -860,6 +884,8 @@ void S9xPutImage (int width, int height)
 	prevHeight = height;
 }
 
+#if PIXEL_BITS == 16
+
 static void Convert16To24 (int width, int height)
 {
 	if (GUI.pixel_format == 565)
@@ -962,6 +988,8 @@ static void Convert16To24Packed (int width, int height)
 	}
 }
 
+#endif
+
 static void Repaint (bool8 isFrameBoundry)
 {
 #ifdef MITSHM
@@ -427,21 +427,17 @@ bool CDirectSound::SetupSound()
 }
 
 /*  CDirectSound::ProcessSound
-Finishes core sample creation, syncronizes the buffer access.
+Finishes core sample creation. The core buffer has one producer and one
+consumer, so the mix timer never has to wait for it.
 */
 void CDirectSound::ProcessSound()
 {
-	EnterCriticalSection(&GUI.SoundCritSect);
-
 	S9xFinalizeSamples();
-
-	LeaveCriticalSection(&GUI.SoundCritSect);
 }
 
 /*  CDirectSound::MixSound
 the mixing function called by the mix timer
 uses the current play position to decide if a new block can be filled with audio data
-synchronizes the core buffer access with a critical section
 */
 void CDirectSound::MixSound()
 {
@@ -479,7 +475,6 @@ void CDirectSound::MixSound()
             return;
 		}
 
-		EnterCriticalSection(&GUI.SoundCritSect);
         if (B1)
 		{
 			S9xMixSamples(B1,(Settings.SixteenBitSound?S1>>1:S1));
@@ -488,8 +483,6 @@ void CDirectSound::MixSound()
 		{
 			S9xMixSamples(B2,(Settings.SixteenBitSound?S2>>1:S2));
 		}
-		LeaveCriticalSection(&GUI.SoundCritSect);
-		
 
         hResult = lpDSB -> Unlock (B1, S1, B2, S2);
         if (!SUCCEEDED(hResult))
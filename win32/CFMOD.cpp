@@ -316,20 +316,16 @@ bool CFMOD::SetupSound()
 }
 
 /*  CFMOD::ProcessSound
-Finishes core sample creation, syncronizes the buffer access.
+Finishes core sample creation. The core buffer has one producer and one
+consumer, so the stream callback never has to wait for it.
 */
 void CFMOD::ProcessSound()
 {
-	EnterCriticalSection(&GUI.SoundCritSect);
-
 	S9xFinalizeSamples();
-
-	LeaveCriticalSection(&GUI.SoundCritSect);
 }
 
 /*  CFMOD::FMODStreamCallback
 the callback that mixes into the stream
-synchronizes the buffer access with a critical section
 IN:
 stream		-	the stream object, unused
 buff		-	the buffer to mix into
@@ -351,14 +347,8 @@ F_CALLBACKAPI CFMOD::FMODStreamCallback (FSOUND_STREAM *stream, void *buff, int
 	CFMOD *S9xFMOD=(CFMOD *)param;
 	int sample_count = Settings.SixteenBitSound?len>>1:len;
 
-	EnterCriticalSection(&GUI.SoundCritSect);
-
 	S9xMixSamples((unsigned char *) buff, sample_count);
 
-	LeaveCriticalSection(&GUI.SoundCritSect);
-
-		
-
 #if defined (FSOUND_LOADRAW)
     return (1);
 #endif
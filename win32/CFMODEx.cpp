@@ -112,11 +112,7 @@ bool CFMODEx::SetupSound()
 
 void CFMODEx::ProcessSound()
 {
-	EnterCriticalSection(&GUI.SoundCritSect);
-
 	S9xFinalizeSamples();
-
-	LeaveCriticalSection(&GUI.SoundCritSect);
 }
 
 FMOD_RESULT F_CALLBACK CFMODEx::FMODExStreamCallback(
@@ -129,12 +125,8 @@ FMOD_RESULT F_CALLBACK CFMODEx::FMODExStreamCallback(
 
 	sample_count >>= (Settings.SixteenBitSound?1:0);
 
-	EnterCriticalSection(&GUI.SoundCritSect);
-
 	S9xMixSamples((unsigned char *) data, sample_count);
 
-	LeaveCriticalSection(&GUI.SoundCritSect);
-
     return FMOD_OK;
 }
 #endif
@@ -985,7 +985,6 @@ void InitSnes9X( void)
     GFX.RealPPL = EXT_PITCH;
 	GFX.Screen = (uint16*)(ScreenBuffer);
 
-	InitializeCriticalSection(&GUI.SoundCritSect);
 	CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
 
     S9xInitAPU();
@@ -1004,7 +1003,6 @@ void DeinitS9x()
 	if(ScreenBuf)
 		delete [] ScreenBuf;
 
-	DeleteCriticalSection(&GUI.SoundCritSect);
 	CoUninitialize();
 	if(GUI.GunSight)
 		DestroyCursor(GUI.GunSight);//= LoadCursor (hInstance, MAKEINTRESOURCE (IDC_CURSOR_SCOPE));
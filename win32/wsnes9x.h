@@ -367,8 +367,6 @@ struct sGUI {
 	int SoundDriver;
 	int SoundBufferSize;
 	bool Mute;
-	// used for sync sound synchronization
-	CRITICAL_SECTION SoundCritSect;
 
     TCHAR RomDir [_MAX_PATH];
     TCHAR ScreensDir [_MAX_PATH];